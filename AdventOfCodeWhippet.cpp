@@ -1,26 +1,7 @@
-#include "AoC2015/AoC2015.h"
-#include "AoC2016/AoC2016.h"
-#include "AoC2017/AoC2017.h"
-#include "AoC2018/AoC2018.h"
-#include "AoC2019/AoC2019.h"
-#include "AoC2020/AoC2020.h"
-#include "AoC2021/AoC2021.h"
-#include "AoC2022/AoC2022.h"
-#include "AoC2023/AoC2023.h"
-#include "AoC2024/AoC2024.h"
-#include "AoC2025/AoC2025.h"
+#include "PuzzleCommandLine.h"
 
-int main()
+// Each puzzle adds itself to the registry with REGISTER_PUZZLE
+int main(int argc, char* argv[])
 {
-	SolveAllPuzzles_2015(R"(.\AoC2015\)");
-	SolveAllPuzzles_2016(R"(.\AoC2016\)");
-	SolveAllPuzzles_2017(R"(.\AoC2017\)");
-	SolveAllPuzzles_2018(R"(.\AoC2018\)");
-	SolveAllPuzzles_2019(R"(.\AoC2019\)");
-	SolveAllPuzzles_2020(R"(.\AoC2020\)");
-	SolveAllPuzzles_2021(R"(.\AoC2021\)");
-	SolveAllPuzzles_2022(R"(.\AoC2022\)");
-	SolveAllPuzzles_2023(R"(.\AoC2023\)");
-	SolveAllPuzzles_2024(R"(.\AoC2024\)");
-	SolveAllPuzzles_2025(R"(.\AoC2025\)");
+	return RunPuzzleCommandLine(argc, argv);
 }
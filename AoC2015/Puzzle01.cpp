@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle01_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle01_2015_Types;
 
-static void Puzzle01_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle01_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle01_B(const string& filename)
+static int64_t Puzzle01_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle01_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle01_2015(const string& filename)
+static int64_t Puzzle01_B(const Model& model)
 {
-	Puzzle01_A(filename);
-	Puzzle01_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 1, A, Parse, Puzzle01_A);
+REGISTER_PARSED_PUZZLE(2015, 1, B, Parse, Puzzle01_B);
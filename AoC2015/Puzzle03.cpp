@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle03_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle03_2015_Types;
 
-static void Puzzle03_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle03_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle03_B(const string& filename)
+static int64_t Puzzle03_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle03_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle03_2015(const string& filename)
+static int64_t Puzzle03_B(const Model& model)
 {
-	Puzzle03_A(filename);
-	Puzzle03_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 3, A, Parse, Puzzle03_A);
+REGISTER_PARSED_PUZZLE(2015, 3, B, Parse, Puzzle03_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle06_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle06_2015_Types;
 
-static void Puzzle06_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle06_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle06_B(const string& filename)
+static int64_t Puzzle06_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle06_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle06_2015(const string& filename)
+static int64_t Puzzle06_B(const Model& model)
 {
-	Puzzle06_A(filename);
-	Puzzle06_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 6, A, Parse, Puzzle06_A);
+REGISTER_PARSED_PUZZLE(2015, 6, B, Parse, Puzzle06_B);
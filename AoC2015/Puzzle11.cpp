@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle11_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle11_2015_Types;
 
-static void Puzzle11_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle11_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle11_B(const string& filename)
+static int64_t Puzzle11_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle11_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle11_2015(const string& filename)
+static int64_t Puzzle11_B(const Model& model)
 {
-	Puzzle11_A(filename);
-	Puzzle11_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 11, A, Parse, Puzzle11_A);
+REGISTER_PARSED_PUZZLE(2015, 11, B, Parse, Puzzle11_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle20_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle20_2015_Types;
 
-static void Puzzle20_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle20_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle20_B(const string& filename)
+static int64_t Puzzle20_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle20_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle20_2015(const string& filename)
+static int64_t Puzzle20_B(const Model& model)
 {
-	Puzzle20_A(filename);
-	Puzzle20_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 20, A, Parse, Puzzle20_A);
+REGISTER_PARSED_PUZZLE(2015, 20, B, Parse, Puzzle20_B);
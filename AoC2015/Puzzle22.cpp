@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle22_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle22_2015_Types;
 
-static void Puzzle22_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle22_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle22_B(const string& filename)
+static int64_t Puzzle22_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle22_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle22_2015(const string& filename)
+static int64_t Puzzle22_B(const Model& model)
 {
-	Puzzle22_A(filename);
-	Puzzle22_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 22, A, Parse, Puzzle22_A);
+REGISTER_PARSED_PUZZLE(2015, 22, B, Parse, Puzzle22_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle23_2015_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle23_2015_Types;
 
-static void Puzzle23_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2015] Puzzle23_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle23_B(const string& filename)
+static int64_t Puzzle23_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2015] Puzzle23_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle23_2015(const string& filename)
+static int64_t Puzzle23_B(const Model& model)
 {
-	Puzzle23_A(filename);
-	Puzzle23_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2015, 23, A, Parse, Puzzle23_A);
+REGISTER_PARSED_PUZZLE(2015, 23, B, Parse, Puzzle23_B);
@@ -1,5 +0,0 @@
-#pragma once
-
-#include <string>
-
-void SolveAllPuzzles_2016(const std::string &directoryName);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle05_2016_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle05_2016_Types;
 
-static void Puzzle05_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2016] Puzzle05_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle05_B(const string& filename)
+static int64_t Puzzle05_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2016] Puzzle05_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle05_2016(const string& filename)
+static int64_t Puzzle05_B(const Model& model)
 {
-	Puzzle05_A(filename);
-	Puzzle05_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2016, 5, A, Parse, Puzzle05_A);
+REGISTER_PARSED_PUZZLE(2016, 5, B, Parse, Puzzle05_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle12_2016_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle12_2016_Types;
 
-static void Puzzle12_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2016] Puzzle12_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle12_B(const string& filename)
+static int64_t Puzzle12_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2016] Puzzle12_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle12_2016(const string& filename)
+static int64_t Puzzle12_B(const Model& model)
 {
-	Puzzle12_A(filename);
-	Puzzle12_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2016, 12, A, Parse, Puzzle12_A);
+REGISTER_PARSED_PUZZLE(2016, 12, B, Parse, Puzzle12_B);
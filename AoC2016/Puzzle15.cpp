@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle15_2016_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle15_2016_Types;
 
-static void Puzzle15_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2016] Puzzle15_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle15_B(const string& filename)
+static int64_t Puzzle15_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2016] Puzzle15_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle15_2016(const string& filename)
+static int64_t Puzzle15_B(const Model& model)
 {
-	Puzzle15_A(filename);
-	Puzzle15_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2016, 15, A, Parse, Puzzle15_A);
+REGISTER_PARSED_PUZZLE(2016, 15, B, Parse, Puzzle15_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle18_2016_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle18_2016_Types;
 
-static void Puzzle18_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2016] Puzzle18_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle18_B(const string& filename)
+static int64_t Puzzle18_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2016] Puzzle18_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle18_2016(const string& filename)
+static int64_t Puzzle18_B(const Model& model)
 {
-	Puzzle18_A(filename);
-	Puzzle18_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2016, 18, A, Parse, Puzzle18_A);
+REGISTER_PARSED_PUZZLE(2016, 18, B, Parse, Puzzle18_B);
@@ -1,57 +0,0 @@
-#include "stdafx.h"
-#include "AoC2017.h"
-
-void Puzzle01_2017(const std::string& filename);
-void Puzzle02_2017(const std::string& filename);
-void Puzzle03_2017(const std::string& filename);
-void Puzzle04_2017(const std::string& filename);
-void Puzzle05_2017(const std::string& filename);
-void Puzzle06_2017(const std::string& filename);
-void Puzzle07_2017(const std::string& filename);
-void Puzzle08_2017(const std::string& filename);
-void Puzzle09_2017(const std::string& filename);
-void Puzzle10_2017(const std::string& filename);
-void Puzzle11_2017(const std::string& filename);
-void Puzzle12_2017(const std::string& filename);
-void Puzzle13_2017(const std::string& filename);
-void Puzzle14_2017(const std::string& filename);
-void Puzzle15_2017(const std::string& filename);
-void Puzzle16_2017(const std::string& filename);
-void Puzzle17_2017(const std::string& filename);
-void Puzzle18_2017(const std::string& filename);
-void Puzzle19_2017(const std::string& filename);
-void Puzzle20_2017(const std::string& filename);
-void Puzzle21_2017(const std::string& filename);
-void Puzzle22_2017(const std::string& filename);
-void Puzzle23_2017(const std::string& filename);
-void Puzzle24_2017(const std::string& filename);
-void Puzzle25_2017(const std::string& filename);
-
-void SolveAllPuzzles_2017(const std::string& directoryName)
-{
-	Puzzle01_2017(directoryName + "Puzzle01.txt");
-	Puzzle02_2017(directoryName + "Puzzle02.txt");
-	Puzzle03_2017(directoryName + "Puzzle03.txt");
-	Puzzle04_2017(directoryName + "Puzzle04.txt");
-	Puzzle05_2017(directoryName + "Puzzle05.txt");
-	Puzzle06_2017(directoryName + "Puzzle06.txt");
-	Puzzle07_2017(directoryName + "Puzzle07.txt");
-	Puzzle08_2017(directoryName + "Puzzle08.txt");
-	Puzzle09_2017(directoryName + "Puzzle09.txt");
-	Puzzle10_2017(directoryName + "Puzzle10.txt");
-	Puzzle11_2017(directoryName + "Puzzle11.txt");
-	Puzzle12_2017(directoryName + "Puzzle12.txt");
-	Puzzle13_2017(directoryName + "Puzzle13.txt");
-	Puzzle14_2017(directoryName + "Puzzle14.txt");
-	Puzzle15_2017(directoryName + "Puzzle15.txt");
-	Puzzle16_2017(directoryName + "Puzzle16.txt");
-	Puzzle17_2017(directoryName + "Puzzle17.txt");
-	Puzzle18_2017(directoryName + "Puzzle18.txt");
-	Puzzle19_2017(directoryName + "Puzzle19.txt");
-	Puzzle20_2017(directoryName + "Puzzle20.txt");
-	Puzzle21_2017(directoryName + "Puzzle21.txt");
-	Puzzle22_2017(directoryName + "Puzzle22.txt");
-	Puzzle23_2017(directoryName + "Puzzle23.txt");
-	Puzzle24_2017(directoryName + "Puzzle24.txt");
-	Puzzle25_2017(directoryName + "Puzzle25.txt");
-}
@@ -1,5 +0,0 @@
-#pragma once
-
-#include <string>
-
-void SolveAllPuzzles_2017(const std::string &directoryName);
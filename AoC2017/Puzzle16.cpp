@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle16_2017_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle16_2017_Types;
 
-static void Puzzle16_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2017] Puzzle16_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle16_B(const string& filename)
+static int64_t Puzzle16_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2017] Puzzle16_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle16_2017(const string& filename)
+static int64_t Puzzle16_B(const Model& model)
 {
-	Puzzle16_A(filename);
-	Puzzle16_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2017, 16, A, Parse, Puzzle16_A);
+REGISTER_PARSED_PUZZLE(2017, 16, B, Parse, Puzzle16_B);
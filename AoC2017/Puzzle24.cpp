@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle24_2017_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle24_2017_Types;
 
-static void Puzzle24_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2017] Puzzle24_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle24_B(const string& filename)
+static int64_t Puzzle24_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2017] Puzzle24_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle24_2017(const string& filename)
+static int64_t Puzzle24_B(const Model& model)
 {
-	Puzzle24_A(filename);
-	Puzzle24_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2017, 24, A, Parse, Puzzle24_A);
+REGISTER_PARSED_PUZZLE(2017, 24, B, Parse, Puzzle24_B);
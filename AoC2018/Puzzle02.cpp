@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle02_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle02_2018_Types;
 
-static void Puzzle02_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle02_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle02_B(const string& filename)
+static int64_t Puzzle02_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle02_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle02_2018(const string& filename)
+static int64_t Puzzle02_B(const Model& model)
 {
-	Puzzle02_A(filename);
-	Puzzle02_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 2, A, Parse, Puzzle02_A);
+REGISTER_PARSED_PUZZLE(2018, 2, B, Parse, Puzzle02_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle08_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle08_2018_Types;
 
-static void Puzzle08_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle08_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle08_B(const string& filename)
+static int64_t Puzzle08_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle08_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle08_2018(const string& filename)
+static int64_t Puzzle08_B(const Model& model)
 {
-	Puzzle08_A(filename);
-	Puzzle08_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 8, A, Parse, Puzzle08_A);
+REGISTER_PARSED_PUZZLE(2018, 8, B, Parse, Puzzle08_B);
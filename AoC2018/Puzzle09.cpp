@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle09_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle09_2018_Types;
 
-static void Puzzle09_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle09_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle09_B(const string& filename)
+static int64_t Puzzle09_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle09_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle09_2018(const string& filename)
+static int64_t Puzzle09_B(const Model& model)
 {
-	Puzzle09_A(filename);
-	Puzzle09_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 9, A, Parse, Puzzle09_A);
+REGISTER_PARSED_PUZZLE(2018, 9, B, Parse, Puzzle09_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle10_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle10_2018_Types;
 
-static void Puzzle10_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle10_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle10_B(const string& filename)
+static int64_t Puzzle10_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle10_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle10_2018(const string& filename)
+static int64_t Puzzle10_B(const Model& model)
 {
-	Puzzle10_A(filename);
-	Puzzle10_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 10, A, Parse, Puzzle10_A);
+REGISTER_PARSED_PUZZLE(2018, 10, B, Parse, Puzzle10_B);
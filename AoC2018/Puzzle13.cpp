@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle13_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle13_2018_Types;
 
-static void Puzzle13_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle13_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle13_B(const string& filename)
+static int64_t Puzzle13_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle13_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle13_2018(const string& filename)
+static int64_t Puzzle13_B(const Model& model)
 {
-	Puzzle13_A(filename);
-	Puzzle13_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 13, A, Parse, Puzzle13_A);
+REGISTER_PARSED_PUZZLE(2018, 13, B, Parse, Puzzle13_B);
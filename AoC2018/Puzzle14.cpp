@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle14_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle14_2018_Types;
 
-static void Puzzle14_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle14_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle14_B(const string& filename)
+static int64_t Puzzle14_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle14_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle14_2018(const string& filename)
+static int64_t Puzzle14_B(const Model& model)
 {
-	Puzzle14_A(filename);
-	Puzzle14_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 14, A, Parse, Puzzle14_A);
+REGISTER_PARSED_PUZZLE(2018, 14, B, Parse, Puzzle14_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle21_2018_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle21_2018_Types;
 
-static void Puzzle21_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2018] Puzzle21_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle21_B(const string& filename)
+static int64_t Puzzle21_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2018] Puzzle21_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle21_2018(const string& filename)
+static int64_t Puzzle21_B(const Model& model)
 {
-	Puzzle21_A(filename);
-	Puzzle21_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2018, 21, A, Parse, Puzzle21_A);
+REGISTER_PARSED_PUZZLE(2018, 21, B, Parse, Puzzle21_B);
@@ -1,5 +0,0 @@
-#pragma once
-
-#include <string>
-
-void SolveAllPuzzles_2019(const std::string &directoryName);
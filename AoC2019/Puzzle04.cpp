@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle04_2019_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle04_2019_Types;
 
-static void Puzzle04_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2019] Puzzle04_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle04_B(const string& filename)
+static int64_t Puzzle04_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2019] Puzzle04_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle04_2019(const string& filename)
+static int64_t Puzzle04_B(const Model& model)
 {
-	Puzzle04_A(filename);
-	Puzzle04_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2019, 4, A, Parse, Puzzle04_A);
+REGISTER_PARSED_PUZZLE(2019, 4, B, Parse, Puzzle04_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle07_2019_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle07_2019_Types;
 
-static void Puzzle07_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2019] Puzzle07_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle07_B(const string& filename)
+static int64_t Puzzle07_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2019] Puzzle07_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle07_2019(const string& filename)
+static int64_t Puzzle07_B(const Model& model)
 {
-	Puzzle07_A(filename);
-	Puzzle07_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2019, 7, A, Parse, Puzzle07_A);
+REGISTER_PARSED_PUZZLE(2019, 7, B, Parse, Puzzle07_B);
@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle17_2019_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle17_2019_Types;
 
-static void Puzzle17_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2019] Puzzle17_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle17_B(const string& filename)
+static int64_t Puzzle17_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2019] Puzzle17_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle17_2019(const string& filename)
+static int64_t Puzzle17_B(const Model& model)
 {
-	Puzzle17_A(filename);
-	Puzzle17_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2019, 17, A, Parse, Puzzle17_A);
+REGISTER_PARSED_PUZZLE(2019, 17, B, Parse, Puzzle17_B);
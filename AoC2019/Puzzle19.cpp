@@ -7,34 +7,41 @@ R"()";
 
 namespace Puzzle19_2019_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle19_2019_Types;
 
-static void Puzzle19_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2019] Puzzle19_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-static void Puzzle19_B(const string& filename)
+static int64_t Puzzle19_A(const Model& model)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	(void)model;
 
 	int64_t answer = 0;
 
-	printf("[2019] Puzzle19_B: %" PRId64 "\n", answer);
+	return answer;
 }
 
-void Puzzle19_2019(const string& filename)
+static int64_t Puzzle19_B(const Model& model)
 {
-	Puzzle19_A(filename);
-	Puzzle19_B(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2019, 19, A, Parse, Puzzle19_A);
+REGISTER_PARSED_PUZZLE(2019, 19, B, Parse, Puzzle19_B);
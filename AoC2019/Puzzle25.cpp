@@ -7,22 +7,31 @@ R"()";
 
 namespace Puzzle25_2019_Types
 {
+	struct Model
+	{
+	};
 }
 
 using namespace Puzzle25_2019_Types;
 
-static void Puzzle25_A(const string &filename)
+static Model Parse(string_view text)
 {
-	(void)filename;
-	ifstream input(filename);
-	//istringstream input(dummy);
+	//text = dummy;
+	ispanstream input(text);
+	(void)input;
 
-	int64_t answer = 0;
+	Model model;
 
-	printf("[2019] Puzzle25_A: %" PRId64 "\n", answer);
+	return model;
 }
 
-void Puzzle25_2019(const string& filename)
+static int64_t Puzzle25_A(const Model& model)
 {
-	Puzzle25_A(filename);
+	(void)model;
+
+	int64_t answer = 0;
+
+	return answer;
 }
+
+REGISTER_PARSED_PUZZLE(2019, 25, A, Parse, Puzzle25_A);
@@ -1,31 +0,0 @@
-#include "stdafx.h"
-#include "AoC2025.h"
-
-void Puzzle01_2025(const std::string& filename);
-void Puzzle02_2025(const std::string& filename);
-void Puzzle03_2025(const std::string& filename);
-void Puzzle04_2025(const std::string& filename);
-void Puzzle05_2025(const std::string& filename);
-void Puzzle06_2025(const std::string& filename);
-void Puzzle07_2025(const std::string& filename);
-void Puzzle08_2025(const std::string& filename);
-void Puzzle09_2025(const std::string& filename);
-void Puzzle10_2025(const std::string& filename);
-void Puzzle11_2025(const std::string& filename);
-void Puzzle12_2025(const std::string& filename);
-
-void SolveAllPuzzles_2025(const std::string& directoryName)
-{
-	Puzzle01_2025(directoryName + "Puzzle01.txt");
-	Puzzle02_2025(directoryName + "Puzzle02.txt");
-	Puzzle03_2025(directoryName + "Puzzle03.txt");
-	Puzzle04_2025(directoryName + "Puzzle04.txt");
-	Puzzle05_2025(directoryName + "Puzzle05.txt");
-	Puzzle06_2025(directoryName + "Puzzle06.txt");
-	Puzzle07_2025(directoryName + "Puzzle07.txt");
-	Puzzle08_2025(directoryName + "Puzzle08.txt");
-	Puzzle09_2025(directoryName + "Puzzle09.txt");
-	Puzzle10_2025(directoryName + "Puzzle10.txt");
-	Puzzle11_2025(directoryName + "Puzzle11.txt");
-	Puzzle12_2025(directoryName + "Puzzle12.txt");
-}
@@ -0,0 +1,265 @@
+#include "stdafx.h"
+#include "AllocationTracking.h"
+
+#include <algorithm>
+#include <new>
+
+#if ALLOCATION_TRACKING_ENABLED && !defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace
+{
+	// Plain thread_locals with no constructors, so touching them never allocates
+	thread_local AllocationScope* CurrentScope = nullptr;
+	thread_local int64_t ThreadAllocations = 0;
+	thread_local int64_t ThreadBytes = 0;
+
+#if ALLOCATION_TRACKING_ENABLED
+	void CountAllocation(void* p, size_t usableSize)
+	{
+		if (p == nullptr)
+			return;
+
+		ThreadAllocations++;
+		ThreadBytes += (int64_t)usableSize;
+		if (CurrentScope != nullptr)
+		{
+			CurrentScope->OnAllocate((int64_t)usableSize);
+		}
+	}
+
+	void CountFree(size_t usableSize)
+	{
+		if (CurrentScope != nullptr)
+		{
+			CurrentScope->OnFree((int64_t)usableSize);
+		}
+	}
+
+	void* TrackedAlloc(size_t size)
+	{
+		void* p = malloc((size > 0) ? size : 1);
+#if defined(_MSC_VER)
+		CountAllocation(p, (p != nullptr) ? _msize(p) : 0);
+#else
+		CountAllocation(p, (p != nullptr) ? malloc_usable_size(p) : 0);
+#endif
+		return p;
+	}
+
+	void TrackedFree(void* p)
+	{
+		if (p == nullptr)
+			return;
+
+#if defined(_MSC_VER)
+		CountFree(_msize(p));
+#else
+		CountFree(malloc_usable_size(p));
+#endif
+		free(p);
+	}
+
+	void* TrackedAlignedAlloc(size_t size, std::align_val_t alignment)
+	{
+		size_t align = (size_t)alignment;
+		size = (size > 0) ? size : 1;
+#if defined(_MSC_VER)
+		void* p = _aligned_malloc(size, align);
+		CountAllocation(p, (p != nullptr) ? _aligned_msize(p, align, 0) : 0);
+#else
+		void* p = aligned_alloc(align, (size + align - 1) & ~(align - 1));
+		CountAllocation(p, (p != nullptr) ? malloc_usable_size(p) : 0);
+#endif
+		return p;
+	}
+
+	void TrackedAlignedFree(void* p, std::align_val_t alignment)
+	{
+		if (p == nullptr)
+			return;
+
+#if defined(_MSC_VER)
+		CountFree(_aligned_msize(p, (size_t)alignment, 0));
+		_aligned_free(p);
+#else
+		(void)alignment;
+		CountFree(malloc_usable_size(p));
+		free(p);
+#endif
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+AllocationScope::AllocationScope()
+	: m_previous(CurrentScope)
+{
+	CurrentScope = this;
+}
+
+AllocationScope::~AllocationScope()
+{
+	CurrentScope = m_previous;
+}
+
+AllocationStats AllocationScope::GetStats() const
+{
+	AllocationStats stats;
+	stats.Allocations = m_allocations.load(std::memory_order_relaxed);
+	stats.Bytes = m_bytes.load(std::memory_order_relaxed);
+	stats.PeakLiveBytes = m_peakLiveBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void AllocationScope::OnAllocate(int64_t bytes)
+{
+	m_allocations.fetch_add(1, std::memory_order_relaxed);
+	m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+	int64_t live = m_liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	int64_t peak = m_peakLiveBytes.load(std::memory_order_relaxed);
+	while ((live > peak) && !m_peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+}
+
+void AllocationScope::OnFree(int64_t bytes)
+{
+	// The block may have come from before this scope started, so don't let it take the live
+	// total below zero or the peak from later allocations would come out short
+	int64_t live = m_liveBytes.load(std::memory_order_relaxed);
+	while (!m_liveBytes.compare_exchange_weak(live, std::max<int64_t>(live - bytes, 0), std::memory_order_relaxed))
+	{
+	}
+}
+
+AllocationScope* GetCurrentAllocationScope()
+{
+	return CurrentScope;
+}
+
+void SetCurrentAllocationScope(AllocationScope* scope)
+{
+	CurrentScope = scope;
+}
+
+void ReadThreadAllocationTotals(int64_t* allocations, int64_t* bytes)
+{
+	*allocations = ThreadAllocations;
+	*bytes = ThreadBytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+#if ALLOCATION_TRACKING_ENABLED
+
+void* operator new(size_t size)
+{
+	void* p = TrackedAlloc(size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* p = TrackedAlignedAlloc(size, alignment);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	TrackedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	TrackedAlignedFree(p, alignment);
+}
+
+#endif
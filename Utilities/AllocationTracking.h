@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Define AOC_TRACK_ALLOCATIONS to replace the global operator new and delete with versions that
+// count every allocation. Without it nothing is replaced and every count stays at zero.
+#if defined(AOC_TRACK_ALLOCATIONS)
+#define ALLOCATION_TRACKING_ENABLED 1
+#else
+#define ALLOCATION_TRACKING_ENABLED 0
+#endif
+
+// Byte counts are the allocator's usable block sizes, which can be a little over what was asked for
+struct AllocationStats
+{
+	int64_t Allocations = 0;
+	int64_t Bytes = 0;
+	int64_t PeakLiveBytes = 0;
+};
+
+// Gathers the allocations made on this thread while it's alive, along with any made by worker
+// threads that ParallelFor starts in the meantime. Scopes nest; the innermost one counts.
+// Frees are charged to whichever scope is current rather than the one that made the allocation,
+// so freeing older blocks inside a scope can hide some of its own growth from PeakLiveBytes.
+class AllocationScope
+{
+public:
+	AllocationScope();
+	~AllocationScope();
+
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+
+	AllocationStats GetStats() const;
+
+	void OnAllocate(int64_t bytes);
+	void OnFree(int64_t bytes);
+
+private:
+	AllocationScope* m_previous;
+	std::atomic<int64_t> m_allocations = 0;
+	std::atomic<int64_t> m_bytes = 0;
+	std::atomic<int64_t> m_liveBytes = 0;
+	std::atomic<int64_t> m_peakLiveBytes = 0;
+};
+
+// For passing the current scope on to worker threads
+AllocationScope* GetCurrentAllocationScope();
+void SetCurrentAllocationScope(AllocationScope* scope);
+
+// Running totals for the calling thread, whatever scope is current. Profile zones take the
+// difference across a zone to attribute allocations to it.
+void ReadThreadAllocationTotals(int64_t* allocations, int64_t* bytes);
+
+//////////////////////////////////////////////////////////////////////////
@@ -1,14 +1,19 @@
 #include "stdafx.h"
 
 ArrayMap2D::ArrayMap2D(Point2 origin, int64_t width, int64_t height, char invalid)
+	: ArrayMap2D(origin, width, height, invalid, nullptr)
+{
+}
+
+ArrayMap2D::ArrayMap2D(Point2 origin, int64_t width, int64_t height, char invalid, std::pmr::memory_resource* resource)
 {
 	m_origin = origin;
 	m_width = width;
 	m_height = height;
+	m_resource = resource;
 
-	int64_t dataSize = GetDataSize();
-	m_pStorage = new char[dataSize];
-	memset(m_pStorage, invalid, dataSize);
+	AllocateStorage();
+	memset(m_pStorage, invalid, GetDataSize());
 
 	m_invalid = invalid;
 }
@@ -19,9 +24,8 @@ ArrayMap2D::ArrayMap2D(const ArrayMap2D& other)
 	m_width = other.m_width;
 	m_height = other.m_height;
 
-	int64_t dataSize = GetDataSize();
-	m_pStorage = new char[dataSize];
-	memcpy(m_pStorage, other.m_pStorage, dataSize);
+	AllocateStorage();
+	memcpy(m_pStorage, other.m_pStorage, GetDataSize());
 
 	m_invalid = other.m_invalid;
 }
@@ -33,6 +37,7 @@ ArrayMap2D::ArrayMap2D(ArrayMap2D&& other) noexcept
 	m_height = other.m_height;
 
 	m_pStorage = other.m_pStorage;
+	m_resource = other.m_resource;
 	other.m_pStorage = nullptr;
 
 	m_invalid = other.m_invalid;
@@ -44,8 +49,8 @@ ArrayMap2D::ArrayMap2D(ArrayMap2DOptions options, const ArrayMap2D& other)
 	m_width = other.m_width;
 	m_height = other.m_height;
 
+	AllocateStorage();
 	int64_t dataSize = GetDataSize();
-	m_pStorage = new char[dataSize];
 	m_invalid = other.m_invalid;
 
 	switch (options)
@@ -64,18 +69,19 @@ ArrayMap2D::ArrayMap2D(ArrayMap2DOptions options, const ArrayMap2D& other)
 
 ArrayMap2D::~ArrayMap2D()
 {
-	delete[] m_pStorage;
+	FreeStorage();
 }
 
 ArrayMap2D& ArrayMap2D::operator=(ArrayMap2D&& other) noexcept
 {
-	delete[] m_pStorage;
+	FreeStorage();
 
 	m_origin = other.m_origin;
 	m_width = other.m_width;
 	m_height = other.m_height;
 
 	m_pStorage = other.m_pStorage;
+	m_resource = other.m_resource;
 	other.m_pStorage = nullptr;
 
 	m_invalid = other.m_invalid;
@@ -85,21 +91,43 @@ ArrayMap2D& ArrayMap2D::operator=(ArrayMap2D&& other) noexcept
 
 ArrayMap2D& ArrayMap2D::operator=(const ArrayMap2D& other)
 {
-	delete[] m_pStorage;
+	FreeStorage();
+	m_resource = nullptr;
 
 	m_origin = other.m_origin;
 	m_width = other.m_width;
 	m_height = other.m_height;
 
-	int64_t dataSize = GetDataSize();
-	m_pStorage = new char[dataSize];
-	memcpy(m_pStorage, other.m_pStorage, dataSize);
+	AllocateStorage();
+	memcpy(m_pStorage, other.m_pStorage, GetDataSize());
 
 	m_invalid = other.m_invalid;
 
 	return *this;
 }
 
+void ArrayMap2D::AllocateStorage()
+{
+	int64_t dataSize = GetDataSize();
+	m_pStorage = (m_resource != nullptr) ? static_cast<char*>(m_resource->allocate(dataSize, 1)) : new char[dataSize];
+}
+
+void ArrayMap2D::FreeStorage()
+{
+	if (m_pStorage == nullptr)
+		return;
+
+	if (m_resource != nullptr)
+	{
+		m_resource->deallocate(m_pStorage, GetDataSize(), 1);
+	}
+	else
+	{
+		delete[] m_pStorage;
+	}
+	m_pStorage = nullptr;
+}
+
 char& ArrayMap2D::operator()(Point2 p)
 {
 	return this->operator()(p.X, p.Y);
@@ -217,6 +245,33 @@ void ArrayMap2D::Replace(char from, char to)
 	}
 }
 
+void ArrayMap2D::DrawLine(Point2 first, Point2 last, char value)
+{
+	if (first.Y == last.Y)
+	{
+		// Horizontal lines are a single clipped run within one row
+		if ((first.Y < m_origin.Y) || (first.Y >= (m_origin.Y + m_height)))
+			return;
+
+		int64_t beginX = std::max(std::min(first.X, last.X), m_origin.X);
+		int64_t endX = std::min(std::max(first.X, last.X) + 1, m_origin.X + m_width);
+		if (beginX < endX)
+		{
+			char* row = m_pStorage + ((first.Y - m_origin.Y) * m_width);
+			memset(row + (beginX - m_origin.X), value, endX - beginX);
+		}
+		return;
+	}
+
+	LineInclusiveRange(first, last).ForEach([this, value](const Point2& p)
+		{
+			if (IsInside(p))
+			{
+				m_pStorage[((p.Y - m_origin.Y) * m_width) + (p.X - m_origin.X)] = value;
+			}
+		});
+}
+
 int64_t ArrayMap2D::Count(char value) const
 {
 	return std::count(m_pStorage, m_pStorage + GetDataSize(), value);
@@ -236,7 +291,7 @@ void ArrayMap2D::Print() const
 		s += m_pStorage[i];
 	}
 
-	printf("%s\n", s.c_str());
+	PuzzlePrintf("%s\n", s.c_str());
 }
 
 void ArrayMap2D::Save(const char* filename) const
@@ -337,8 +392,14 @@ ArrayMap2DAxisIterator ArrayMap2DAxis::end() const
 
 ArrayMap2D ReadArrayMap(std::istream& input, char emptyChar)
 {
-	std::vector<std::string> lines = ReadAllLines(input);
-	ArrayMap2D ret(Point2{ 0, 0 }, (int64_t)lines[0].size(), (int64_t)lines.size(), emptyChar);
+	return ReadArrayMap(input, emptyChar, nullptr);
+}
+
+ArrayMap2D ReadArrayMap(std::istream& input, char emptyChar, std::pmr::memory_resource* resource)
+{
+	PROFILE_SCOPE("ReadArrayMap");
+	std::pmr::vector<std::pmr::string> lines = ReadAllLines(input, (resource != nullptr) ? resource : std::pmr::get_default_resource());
+	ArrayMap2D ret(Point2{ 0, 0 }, (int64_t)lines[0].size(), (int64_t)lines.size(), emptyChar, resource);
 
 	for (int64_t y = 0; y < (int64_t)lines.size(); y++)
 	{
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <stdint.h>
 
 class ArrayMap2D;
@@ -99,6 +100,11 @@ class ArrayMap2D
 public:
 
 	ArrayMap2D(Point2 origin, int64_t width, int64_t height, char invalid);
+
+	// Storage comes from resource, e.g. GetPuzzleArena(). Copies, clones and copy assignment
+	// always put their storage on the heap; moves take the storage along with its resource.
+	ArrayMap2D(Point2 origin, int64_t width, int64_t height, char invalid, std::pmr::memory_resource* resource);
+
 	ArrayMap2D(const ArrayMap2D& other);
 	ArrayMap2D(ArrayMap2DOptions options, const ArrayMap2D& other);
 	ArrayMap2D(ArrayMap2D&& other) noexcept;
@@ -128,6 +134,7 @@ public:
 
 	char GetInvalidCharacter() const;
 	void Replace(char from, char to);
+	void DrawLine(Point2 first, Point2 last, char value);
 
 	int64_t Count(char value) const;
 
@@ -139,6 +146,8 @@ public:
 private:
 
 	int64_t GetDataSize() const;
+	void AllocateStorage();
+	void FreeStorage();
 
 	Point2 m_origin;
 	int64_t m_width;
@@ -146,6 +155,10 @@ private:
 
 	char* m_pStorage;
 	char m_invalid;
+
+	// Null for plain new[] and delete[]
+	std::pmr::memory_resource* m_resource = nullptr;
 };
 
 ArrayMap2D ReadArrayMap(std::istream& input, char emptyChar = '.');
+ArrayMap2D ReadArrayMap(std::istream& input, char emptyChar, std::pmr::memory_resource* resource);
@@ -0,0 +1,8 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////
+
+// True when the CPU and OS both support 256-bit AVX2 registers
+bool CpuSupportsAVX2();
+
+//////////////////////////////////////////////////////////////////////////
@@ -7,9 +7,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "Point2.h"
+#include "PointIteration.h"
 #include "Vector3.h"
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <set>
 #include <map>
@@ -17,6 +19,11 @@
 #include <optional>
 #include <string>
 #include <regex>
+#include <span>
+#include <numeric>
+#include <algorithm>
+
+#include <assert.h>
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -28,6 +35,20 @@ struct is_pair<std::pair<T1, T2>> : std::true_type {};
 
 //////////////////////////////////////////////////////////////////////////
 
+// Stages go on the heap unless the chain was started with a memory resource, e.g.
+// MakeEnumerator(v, GetPuzzleArena()); every stage built from it then comes from the same one
+template <typename STAGE, typename... ARGS>
+inline std::shared_ptr<STAGE> MakeEnumeratorStage(std::pmr::memory_resource* resource, ARGS&&... args)
+{
+	std::shared_ptr<STAGE> stage = (resource != nullptr)
+		? std::allocate_shared<STAGE>(std::pmr::polymorphic_allocator<STAGE>(resource), std::forward<ARGS>(args)...)
+		: std::make_shared<STAGE>(std::forward<ARGS>(args)...);
+	stage->m_resource = resource;
+	return stage;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 class IEnumerator : public std::enable_shared_from_this<IEnumerator<T>>
 {
@@ -40,6 +61,7 @@ public:
 
 	IEnumerator(std::shared_ptr<IEnumerator> source)
 		: m_source(source)
+		, m_resource((source != nullptr) ? source->m_resource : nullptr)
 	{
 	}
 
@@ -70,6 +92,27 @@ public:
 
 	std::shared_ptr<IEnumerator<T>> Distinct();
 
+	std::shared_ptr<IEnumerator<T>> TakeWhile(const std::function<bool(const T&)>& predicate);
+	std::shared_ptr<IEnumerator<T>> SkipWhile(const std::function<bool(const T&)>& predicate);
+
+	std::shared_ptr<IEnumerator<std::vector<T>>> Window(int64_t size);
+	std::shared_ptr<IEnumerator<std::pair<T, T>>> Pairwise();
+
+	template <typename OTHER_TYPE>
+	std::shared_ptr<IEnumerator<std::pair<T, OTHER_TYPE>>> Zip(std::shared_ptr<IEnumerator<OTHER_TYPE>> other);
+
+	// GroupBy and OrderBy read the source once into a single buffer of (key, value) records and
+	// stably sort it. GroupBy then moves the values into one buffer owned by the stage; group
+	// spans point into it and stay valid until the stage is reset or destroyed
+	template <typename KEY>
+	std::shared_ptr<IEnumerator<std::pair<KEY, std::span<const T>>>> GroupBy(const std::function<KEY(const T&)>& keySelector);
+
+	template <typename KEY>
+	std::shared_ptr<IEnumerator<T>> OrderBy(const std::function<KEY(const T&)>& keySelector);
+
+	template <typename ACCUMULATE>
+	ACCUMULATE Aggregate(ACCUMULATE seed, const std::function<ACCUMULATE(const ACCUMULATE&, const T&)>& func);
+
 	int64_t Count();
 	T Min();
 	T Max();
@@ -87,7 +130,13 @@ public:
 	void Execute();
 
 protected:
+	template <typename STAGE, typename... ARGS>
+	friend std::shared_ptr<STAGE> MakeEnumeratorStage(std::pmr::memory_resource* resource, ARGS&&... args);
+
 	std::shared_ptr<IEnumerator<T>> m_source;
+
+	// Where the stages chained on from this one are allocated; null for the heap
+	std::pmr::memory_resource* m_resource = nullptr;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -133,9 +182,9 @@ private:
 };
 
 template <typename T>
-inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::vector<T>& source)
+inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::vector<T>& source, std::pmr::memory_resource* resource = nullptr)
 {
-	return std::make_shared<IEnumerator<T>>(std::make_shared<Enumerator_Vector<T>>(source));
+	return MakeEnumeratorStage<IEnumerator<T>>(resource, MakeEnumeratorStage<Enumerator_Vector<T>>(resource, source));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -181,9 +230,9 @@ private:
 };
 
 template <typename T>
-inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::basic_string<T>& source)
+inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::basic_string<T>& source, std::pmr::memory_resource* resource = nullptr)
 {
-	return std::make_shared<IEnumerator<T>>(std::make_shared<Enumerator_String<T>>(source));
+	return MakeEnumeratorStage<IEnumerator<T>>(resource, MakeEnumeratorStage<Enumerator_String<T>>(resource, source));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -244,19 +293,19 @@ private:
 };
 
 template <typename T>
-inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::set<T>& source)
+inline std::shared_ptr<IEnumerator<T>> MakeEnumerator(const std::set<T>& source, std::pmr::memory_resource* resource = nullptr)
 {
-	return std::make_shared<IEnumerator<T>>(std::make_shared<Enumerator_Set<T>>(source));
+	return MakeEnumeratorStage<IEnumerator<T>>(resource, MakeEnumeratorStage<Enumerator_Set<T>>(resource, source));
 }
 
 //////////////////////////////////////////////////////////////////////////
 
-template <typename KEY, typename VALUE>
+template <typename KEY, typename VALUE, typename COMPARE = std::less<KEY>, typename ALLOCATOR = std::allocator<std::pair<const KEY, VALUE>>>
 class Enumerator_Map : public IEnumerator<typename std::pair<KEY, VALUE>>
 {
 public:
 
-	Enumerator_Map(const std::map<KEY, VALUE>& source)
+	Enumerator_Map(const std::map<KEY, VALUE, COMPARE, ALLOCATOR>& source)
 		: m_mapSource(source)
 		, m_current()
 	{
@@ -264,7 +313,7 @@ public:
 
 	virtual bool MoveNext() override
 	{
-		typename std::map<KEY, VALUE>::const_iterator next;
+		typename std::map<KEY, VALUE, COMPARE, ALLOCATOR>::const_iterator next;
 		if (m_current.has_value())
 		{
 			next = m_current.value();
@@ -291,7 +340,7 @@ public:
 		if (m_current.has_value() == false)
 			return false;
 
-		typename std::map<KEY, VALUE>::const_iterator current = m_current.value();
+		typename std::map<KEY, VALUE, COMPARE, ALLOCATOR>::const_iterator current = m_current.value();
 		if (current != m_mapSource.end())
 		{
 			*value = *current;
@@ -302,14 +351,15 @@ public:
 	}
 
 private:
-	const std::map<KEY, VALUE>& m_mapSource;
-	std::optional<typename std::map<KEY, VALUE>::const_iterator> m_current;
+	const std::map<KEY, VALUE, COMPARE, ALLOCATOR>& m_mapSource;
+	std::optional<typename std::map<KEY, VALUE, COMPARE, ALLOCATOR>::const_iterator> m_current;
 };
 
-template <typename KEY, typename VALUE>
-inline std::shared_ptr<IEnumerator<std::pair<KEY, VALUE>>> MakeEnumerator(const std::map<KEY, VALUE>& source)
+// Any comparer or allocator, so std::pmr::map sources such as PointMap::Data work too
+template <typename KEY, typename VALUE, typename COMPARE, typename ALLOCATOR>
+inline std::shared_ptr<IEnumerator<std::pair<KEY, VALUE>>> MakeEnumerator(const std::map<KEY, VALUE, COMPARE, ALLOCATOR>& source, std::pmr::memory_resource* resource = nullptr)
 {
-	return std::make_shared<IEnumerator<std::pair<KEY, VALUE>>>(std::make_shared<Enumerator_Map<KEY, VALUE>>(source));
+	return MakeEnumeratorStage<IEnumerator<std::pair<KEY, VALUE>>>(resource, MakeEnumeratorStage<Enumerator_Map<KEY, VALUE, COMPARE, ALLOCATOR>>(resource, source));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -353,14 +403,14 @@ private:
 
 namespace Enumerable
 {
-	inline std::shared_ptr<IEnumerator<int>> Range(int start, int count)
+	inline std::shared_ptr<IEnumerator<int>> Range(int start, int count, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<int>>(std::make_shared<Enumerator_Range<int>>(start, count));
+		return MakeEnumeratorStage<IEnumerator<int>>(resource, MakeEnumeratorStage<Enumerator_Range<int>>(resource, start, count));
 	}
 
-	inline std::shared_ptr<IEnumerator<int64_t>> Range(int64_t start, int64_t count)
+	inline std::shared_ptr<IEnumerator<int64_t>> Range(int64_t start, int64_t count, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<int64_t>>(std::make_shared<Enumerator_Range<int64_t>>(start, count));
+		return MakeEnumeratorStage<IEnumerator<int64_t>>(resource, MakeEnumeratorStage<Enumerator_Range<int64_t>>(resource, start, count));
 	}
 }
 
@@ -372,55 +422,53 @@ class Enumerator_Line : public IEnumerator<T>
 public:
 
 	Enumerator_Line(const Point2& first, const Point2& last)
-		: m_diff({ 0, 0 })
+		: m_line(first, last)
+		, m_current(m_line.begin())
+		, m_end(m_line.end())
+		, m_started(false)
 	{
-		if (first.X != last.X)
-		{
-			m_diff.X = (first.X < last.X) ? 1 : -1;
-		}
-		if (first.Y != last.Y)
-		{
-			m_diff.Y = (first.Y < last.Y) ? 1 : -1;
-		}
-
-		m_start = first - m_diff;
-		m_stop = last + m_diff;
-
-		m_current = m_start;
 	}
 
 	virtual bool MoveNext() override
 	{
-		m_current = m_current + m_diff;
-		return (m_current != m_stop);
+		if (m_started == false)
+		{
+			m_started = true;
+		}
+		else if (m_current != m_end)
+		{
+			++m_current;
+		}
+		return (m_current != m_end);
 	}
 
 	virtual void Reset() override
 	{
-		m_current = m_start;
+		m_current = m_line.begin();
+		m_started = false;
 	}
 
 	virtual bool GetCurrent(T* value) override
 	{
-		if ((m_current == m_start) || (m_current == m_stop))
+		if ((m_started == false) || (m_current == m_end))
 			return false;
 
-		*value = m_current;
+		*value = *m_current;
 		return true;
 	}
 
 private:
-	Point2 m_start;
-	Point2 m_stop;
-	Point2 m_diff;
-	Point2 m_current;
+	LineInclusiveRange m_line;
+	LineIterator m_current;
+	LineIterator m_end;
+	bool m_started;
 };
 
 namespace Enumerable
 {
-	inline std::shared_ptr<IEnumerator<Point2>> Line(const Point2 &first, const Point2 &last)
+	inline std::shared_ptr<IEnumerator<Point2>> Line(const Point2 &first, const Point2 &last, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<Point2>>(std::make_shared<Enumerator_Line<Point2>>(first, last));
+		return MakeEnumeratorStage<IEnumerator<Point2>>(resource, MakeEnumeratorStage<Enumerator_Line<Point2>>(resource, first, last));
 	}
 }
 
@@ -482,9 +530,9 @@ private:
 
 namespace Enumerable
 {
-	inline std::shared_ptr<IEnumerator<Vector3>> Line3D(const Vector3& first, const Vector3& last)
+	inline std::shared_ptr<IEnumerator<Vector3>> Line3D(const Vector3& first, const Vector3& last, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<Vector3>>(std::make_shared<Enumerator_Line3D<Vector3>>(first, last));
+		return MakeEnumeratorStage<IEnumerator<Vector3>>(resource, MakeEnumeratorStage<Enumerator_Line3D<Vector3>>(resource, first, last));
 	}
 }
 
@@ -637,6 +685,408 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+class Enumerator_TakeWhile : public IEnumerator<T>
+{
+public:
+
+	Enumerator_TakeWhile(const std::function<bool(const T&)>& predicate, std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<T>(source)
+		, m_predicate(predicate)
+		, m_finished(false)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		if (m_finished || (this->m_source->MoveNext() == false))
+		{
+			return false;
+		}
+
+		T candidate;
+		this->m_source->GetCurrent(&candidate);
+		m_finished = !m_predicate(candidate);
+		return !m_finished;
+	}
+
+	virtual void Reset() override
+	{
+		this->m_source->Reset();
+		m_finished = false;
+	}
+
+	virtual bool GetCurrent(T* value) override
+	{
+		if (m_finished)
+			return false;
+
+		return this->m_source->GetCurrent(value);
+	}
+
+private:
+
+	std::function<bool(const T&)> m_predicate;
+	bool m_finished;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class Enumerator_SkipWhile : public IEnumerator<T>
+{
+public:
+
+	Enumerator_SkipWhile(const std::function<bool(const T&)>& predicate, std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<T>(source)
+		, m_predicate(predicate)
+		, m_skipping(true)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		while (this->m_source->MoveNext())
+		{
+			if (m_skipping == false)
+			{
+				return true;
+			}
+
+			T candidate;
+			this->m_source->GetCurrent(&candidate);
+			if (m_predicate(candidate) == false)
+			{
+				m_skipping = false;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual void Reset() override
+	{
+		this->m_source->Reset();
+		m_skipping = true;
+	}
+
+private:
+
+	std::function<bool(const T&)> m_predicate;
+	bool m_skipping;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class Enumerator_Window : public IEnumerator<std::vector<T>>
+{
+public:
+
+	Enumerator_Window(int64_t size, std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<std::vector<T>>(nullptr)
+		, m_wrappedSource(source)
+		, m_size(size)
+		, m_head(0)
+	{
+		assert(m_size > 0);
+		m_ring.reserve(m_size);
+	}
+
+	virtual bool MoveNext() override
+	{
+		// Fill the window on the first step, then slide it by one element per step
+		while (m_wrappedSource->MoveNext())
+		{
+			T next;
+			m_wrappedSource->GetCurrent(&next);
+
+			if (static_cast<int64_t>(m_ring.size()) < m_size)
+			{
+				m_ring.emplace_back(std::move(next));
+				if (static_cast<int64_t>(m_ring.size()) == m_size)
+				{
+					return true;
+				}
+			}
+			else
+			{
+				m_ring[m_head] = std::move(next);
+				m_head = (m_head + 1) % m_size;
+				return true;
+			}
+		}
+		m_ring.clear();
+		m_head = 0;
+		return false;
+	}
+
+	virtual void Reset() override
+	{
+		m_wrappedSource->Reset();
+		m_ring.clear();
+		m_head = 0;
+	}
+
+	virtual bool GetCurrent(std::vector<T>* value) override
+	{
+		if (static_cast<int64_t>(m_ring.size()) < m_size)
+			return false;
+
+		value->clear();
+		value->reserve(m_size);
+		value->insert(value->end(), m_ring.begin() + m_head, m_ring.end());
+		value->insert(value->end(), m_ring.begin(), m_ring.begin() + m_head);
+		return true;
+	}
+
+private:
+
+	std::shared_ptr<IEnumerator<T>> m_wrappedSource;
+	int64_t m_size;
+	int64_t m_head;
+	std::vector<T> m_ring;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class Enumerator_Pairwise : public IEnumerator<std::pair<T, T>>
+{
+public:
+
+	Enumerator_Pairwise(std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<std::pair<T, T>>(nullptr)
+		, m_wrappedSource(source)
+		, m_available(0)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		while (m_wrappedSource->MoveNext())
+		{
+			m_current.first = std::move(m_current.second);
+			m_wrappedSource->GetCurrent(&m_current.second);
+			if (++m_available >= 2)
+			{
+				return true;
+			}
+		}
+		m_available = 0;
+		return false;
+	}
+
+	virtual void Reset() override
+	{
+		m_wrappedSource->Reset();
+		m_available = 0;
+	}
+
+	virtual bool GetCurrent(std::pair<T, T>* value) override
+	{
+		if (m_available < 2)
+			return false;
+
+		*value = m_current;
+		return true;
+	}
+
+private:
+
+	std::shared_ptr<IEnumerator<T>> m_wrappedSource;
+	std::pair<T, T> m_current;
+	int64_t m_available;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename OTHER_TYPE>
+class Enumerator_Zip : public IEnumerator<std::pair<T, OTHER_TYPE>>
+{
+public:
+
+	Enumerator_Zip(std::shared_ptr<IEnumerator<T>> first, std::shared_ptr<IEnumerator<OTHER_TYPE>> second)
+		: IEnumerator<std::pair<T, OTHER_TYPE>>(nullptr)
+		, m_first(first)
+		, m_second(second)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		return m_first->MoveNext() && m_second->MoveNext();
+	}
+
+	virtual void Reset() override
+	{
+		m_first->Reset();
+		m_second->Reset();
+	}
+
+	virtual bool GetCurrent(std::pair<T, OTHER_TYPE>* value) override
+	{
+		return m_first->GetCurrent(&value->first) && m_second->GetCurrent(&value->second);
+	}
+
+private:
+
+	std::shared_ptr<IEnumerator<T>> m_first;
+	std::shared_ptr<IEnumerator<OTHER_TYPE>> m_second;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace Enumerable_Detail
+{
+	// Reads the whole source into one buffer of (key, value) records and stably sorts it by key
+	template <typename T, typename KEY>
+	void MaterialiseSortedByKey(IEnumerator<T>& source, const std::function<KEY(const T&)>& keySelector,
+		std::vector<std::pair<KEY, T>>* records)
+	{
+		records->clear();
+
+		source.Reset();
+		while (source.MoveNext())
+		{
+			T next;
+			source.GetCurrent(&next);
+			KEY key = keySelector(next);
+			records->emplace_back(std::move(key), std::move(next));
+		}
+
+		std::ranges::stable_sort(*records, [](const std::pair<KEY, T>& a, const std::pair<KEY, T>& b) { return a.first < b.first; });
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename KEY>
+class Enumerator_OrderBy : public IEnumerator<T>
+{
+public:
+
+	Enumerator_OrderBy(const std::function<KEY(const T&)>& keySelector, std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<T>(source)
+		, m_keySelector(keySelector)
+		, m_materialised(false)
+		, m_currentPos(-1)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		if (m_materialised == false)
+		{
+			Enumerable_Detail::MaterialiseSortedByKey(*this->m_source, m_keySelector, &m_buffer);
+			m_materialised = true;
+		}
+		return (++m_currentPos < static_cast<int64_t>(m_buffer.size()));
+	}
+
+	virtual void Reset() override
+	{
+		m_materialised = false;
+		m_currentPos = -1;
+	}
+
+	virtual bool GetCurrent(T* value) override
+	{
+		if ((m_currentPos < 0) || (m_currentPos >= static_cast<int64_t>(m_buffer.size())))
+			return false;
+
+		*value = m_buffer[m_currentPos].second;
+		return true;
+	}
+
+private:
+
+	std::function<KEY(const T&)> m_keySelector;
+	std::vector<std::pair<KEY, T>> m_buffer;
+	bool m_materialised;
+	int64_t m_currentPos;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename KEY>
+class Enumerator_GroupBy : public IEnumerator<std::pair<KEY, std::span<const T>>>
+{
+public:
+
+	Enumerator_GroupBy(const std::function<KEY(const T&)>& keySelector, std::shared_ptr<IEnumerator<T>> source)
+		: IEnumerator<std::pair<KEY, std::span<const T>>>(nullptr)
+		, m_wrappedSource(source)
+		, m_keySelector(keySelector)
+		, m_materialised(false)
+		, m_currentGroup(-1)
+	{
+	}
+
+	virtual bool MoveNext() override
+	{
+		if (m_materialised == false)
+		{
+			Materialise();
+		}
+		return (++m_currentGroup < static_cast<int64_t>(m_groupStarts.size()) - 1);
+	}
+
+	virtual void Reset() override
+	{
+		m_materialised = false;
+		m_currentGroup = -1;
+	}
+
+	virtual bool GetCurrent(std::pair<KEY, std::span<const T>>* value) override
+	{
+		if ((m_currentGroup < 0) || (m_currentGroup >= static_cast<int64_t>(m_groupStarts.size()) - 1))
+			return false;
+
+		size_t begin = m_groupStarts[m_currentGroup];
+		size_t end = m_groupStarts[m_currentGroup + 1];
+		value->first = m_groupKeys[m_currentGroup];
+		value->second = std::span<const T>(m_buffer.data() + begin, end - begin);
+		return true;
+	}
+
+private:
+
+	void Materialise()
+	{
+		std::vector<std::pair<KEY, T>> records;
+		Enumerable_Detail::MaterialiseSortedByKey(*m_wrappedSource, m_keySelector, &records);
+
+		// Spans need the values next to each other, so move them out of the records; each
+		// group only needs its key once
+		m_buffer.clear();
+		m_buffer.reserve(records.size());
+		m_groupKeys.clear();
+		m_groupStarts.clear();
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			if ((i == 0) || (records[i - 1].first < records[i].first))
+			{
+				m_groupKeys.push_back(records[i].first);
+				m_groupStarts.push_back(i);
+			}
+			m_buffer.push_back(std::move(records[i].second));
+		}
+		m_groupStarts.push_back(records.size());
+		m_materialised = true;
+	}
+
+	std::shared_ptr<IEnumerator<T>> m_wrappedSource;
+	std::function<KEY(const T&)> m_keySelector;
+	std::vector<T> m_buffer;
+	std::vector<KEY> m_groupKeys;
+	std::vector<size_t> m_groupStarts;
+	bool m_materialised;
+	int64_t m_currentGroup;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 class Enumerator_Regex : public IEnumerator<std::smatch>
 {
 public:
@@ -695,9 +1145,9 @@ private:
 
 namespace Enumerable
 {
-	inline std::shared_ptr<IEnumerator<std::smatch>> Regex(const std::string& source, const std::regex& pattern)
+	inline std::shared_ptr<IEnumerator<std::smatch>> Regex(const std::string& source, const std::regex& pattern, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<std::smatch>>(std::make_shared<Enumerator_Regex>(source, pattern));
+		return MakeEnumeratorStage<IEnumerator<std::smatch>>(resource, MakeEnumeratorStage<Enumerator_Regex>(resource, source, pattern));
 	}
 }
 
@@ -747,9 +1197,9 @@ private:
 
 namespace Enumerable
 {
-	inline std::shared_ptr<IEnumerator<std::string>> Tokens(const std::string& source, const std::string& delimiters)
+	inline std::shared_ptr<IEnumerator<std::string>> Tokens(const std::string& source, const std::string& delimiters, std::pmr::memory_resource* resource = nullptr)
 	{
-		return std::make_shared<IEnumerator<std::string>>(std::make_shared<Enumerator_Token>(source, delimiters));
+		return MakeEnumeratorStage<IEnumerator<std::string>>(resource, MakeEnumeratorStage<Enumerator_Token>(resource, source, delimiters));
 	}
 }
 
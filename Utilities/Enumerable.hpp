@@ -68,7 +68,7 @@ std::map<KEY, VALUE> IEnumerator<T>::ToMap()
 template <typename T>
 std::shared_ptr<IEnumerator<T>> IEnumerator<T>::Where(const std::function<bool(const T&)> &predicate)
 {
-	return std::make_shared<IEnumerator<T>>(std::make_shared<Enumerator_Where<T>>(predicate, this->shared_from_this()));
+	return MakeEnumeratorStage<IEnumerator<T>>(this->m_resource, MakeEnumeratorStage<Enumerator_Where<T>>(this->m_resource, predicate, this->shared_from_this()));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -77,7 +77,7 @@ template <typename T>
 template <typename OUT_TYPE>
 std::shared_ptr<IEnumerator<OUT_TYPE>> IEnumerator<T>::Select(const std::function<OUT_TYPE(const T&)>& transform)
 {
-	return std::make_shared<IEnumerator<OUT_TYPE>>(std::make_shared<Enumerator_Select<OUT_TYPE, T>>(transform, this->shared_from_this()));
+	return MakeEnumeratorStage<IEnumerator<OUT_TYPE>>(this->m_resource, MakeEnumeratorStage<Enumerator_Select<OUT_TYPE, T>>(this->m_resource, transform, this->shared_from_this()));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -86,7 +86,7 @@ template<typename T>
 template<typename OUT_TYPE>
 inline std::shared_ptr<IEnumerator<OUT_TYPE>> IEnumerator<T>::Convert()
 {
-	return std::make_shared<IEnumerator<OUT_TYPE>>(std::make_shared<Enumerator_Convert<OUT_TYPE, T>>(this->shared_from_this()));
+	return MakeEnumeratorStage<IEnumerator<OUT_TYPE>>(this->m_resource, MakeEnumeratorStage<Enumerator_Convert<OUT_TYPE, T>>(this->m_resource, this->shared_from_this()));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -196,7 +196,85 @@ T IEnumerator<T>::Product()
 template <typename T>
 std::shared_ptr<IEnumerator<T>> IEnumerator<T>::Distinct()
 {
-	return std::make_shared<IEnumerator<T>>(std::make_shared<Enumerator_Distinct<T>>(this->shared_from_this()));
+	return MakeEnumeratorStage<IEnumerator<T>>(this->m_resource, MakeEnumeratorStage<Enumerator_Distinct<T>>(this->m_resource, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::shared_ptr<IEnumerator<T>> IEnumerator<T>::TakeWhile(const std::function<bool(const T&)>& predicate)
+{
+	return MakeEnumeratorStage<IEnumerator<T>>(this->m_resource, MakeEnumeratorStage<Enumerator_TakeWhile<T>>(this->m_resource, predicate, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::shared_ptr<IEnumerator<T>> IEnumerator<T>::SkipWhile(const std::function<bool(const T&)>& predicate)
+{
+	return MakeEnumeratorStage<IEnumerator<T>>(this->m_resource, MakeEnumeratorStage<Enumerator_SkipWhile<T>>(this->m_resource, predicate, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::shared_ptr<IEnumerator<std::vector<T>>> IEnumerator<T>::Window(int64_t size)
+{
+	return MakeEnumeratorStage<IEnumerator<std::vector<T>>>(this->m_resource, MakeEnumeratorStage<Enumerator_Window<T>>(this->m_resource, size, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::shared_ptr<IEnumerator<std::pair<T, T>>> IEnumerator<T>::Pairwise()
+{
+	return MakeEnumeratorStage<IEnumerator<std::pair<T, T>>>(this->m_resource, MakeEnumeratorStage<Enumerator_Pairwise<T>>(this->m_resource, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename OTHER_TYPE>
+std::shared_ptr<IEnumerator<std::pair<T, OTHER_TYPE>>> IEnumerator<T>::Zip(std::shared_ptr<IEnumerator<OTHER_TYPE>> other)
+{
+	return MakeEnumeratorStage<IEnumerator<std::pair<T, OTHER_TYPE>>>(this->m_resource, MakeEnumeratorStage<Enumerator_Zip<T, OTHER_TYPE>>(this->m_resource, this->shared_from_this(), other));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename KEY>
+std::shared_ptr<IEnumerator<std::pair<KEY, std::span<const T>>>> IEnumerator<T>::GroupBy(const std::function<KEY(const T&)>& keySelector)
+{
+	return MakeEnumeratorStage<IEnumerator<std::pair<KEY, std::span<const T>>>>(this->m_resource, MakeEnumeratorStage<Enumerator_GroupBy<T, KEY>>(this->m_resource, keySelector, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename KEY>
+std::shared_ptr<IEnumerator<T>> IEnumerator<T>::OrderBy(const std::function<KEY(const T&)>& keySelector)
+{
+	return MakeEnumeratorStage<IEnumerator<T>>(this->m_resource, MakeEnumeratorStage<Enumerator_OrderBy<T, KEY>>(this->m_resource, keySelector, this->shared_from_this()));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename ACCUMULATE>
+ACCUMULATE IEnumerator<T>::Aggregate(ACCUMULATE seed, const std::function<ACCUMULATE(const ACCUMULATE&, const T&)>& func)
+{
+	m_source->Reset();
+
+	ACCUMULATE accumulated = std::move(seed);
+	while (m_source->MoveNext())
+	{
+		T v;
+		m_source->GetCurrent(&v);
+		accumulated = func(accumulated, v);
+	}
+
+	return accumulated;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "FileInput.h"
+#include "PuzzleInput.h"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -31,10 +32,26 @@ std::vector<std::string> ReadAllLines(const char* filename)
 	return ReadAllLines(input);
 }
 
+std::pmr::vector<std::pmr::string> ReadAllLines(std::istream& input, std::pmr::memory_resource* resource)
+{
+	std::pmr::vector<std::pmr::string> lines(resource);
+	while (true)
+	{
+		std::pmr::string line(resource);
+		if (!std::getline(input, line))
+			break;
+
+		lines.push_back(std::move(line));
+	}
+
+	return lines;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 InputLineRange ReadEachLine(std::istream& input)
 {
+	PROFILE_SCOPE("ReadEachLine");
 	return InputLineRange{ ILineSource::CreateFromStream(input) };
 }
 
@@ -45,6 +62,7 @@ InputLineWithNumberRange ReadEachLineWithNumber(std::istream& input)
 
 InputLineRegexRange ReadEachLine(std::istream& input, const std::regex& pattern)
 {
+	PROFILE_SCOPE("ReadEachLine");
 	return InputLineRegexRange{ ILineSource::CreateFromStream(input), pattern };
 }
 
@@ -154,10 +172,46 @@ private:
 
 //////////////////////////////////////////////////////////////////////////
 
+class LineSource_Cached : public ILineSource
+{
+public:
+	LineSource_Cached(std::shared_ptr<const PuzzleInputData> input)
+		: Input(std::move(input))
+	{
+	}
+
+	const char* GetNextLine(const char* currentLine) const override
+	{
+		const std::vector<char>& data = Input->Lines;
+		if (currentLine == nullptr)
+		{
+			return data.empty() ? nullptr : data.data();
+		}
+
+		const char* end = data.data() + data.size();
+
+		assert(currentLine >= data.data());
+		assert(currentLine < end);
+
+		// Find the end of the line (we're guaranteed a null terminator)
+		while (*currentLine != '\0')
+			currentLine++;
+
+		// Next line
+		currentLine++;
+
+		return (currentLine >= end ? nullptr : currentLine);
+	}
+
+private:
+	std::shared_ptr<const PuzzleInputData> Input;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 std::shared_ptr<ILineSource> ILineSource::CreateFromFile(const char* filename)
 {
-	(void)filename;
-	return std::shared_ptr<ILineSource>();
+	return std::make_shared<LineSource_Cached>(GetPuzzleInputData(filename));
 }
 
 std::shared_ptr<ILineSource> ILineSource::CreateFromString(const std::string& s)
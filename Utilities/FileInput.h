@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <fstream>
+#include <memory_resource>
 #include <assert.h>
 
 //////////////////////////////////////////////////////////////////////////
@@ -10,6 +11,9 @@ std::string ReadSingleLine(std::istream& input);
 std::vector<std::string> ReadAllLines(std::istream& input);
 std::vector<std::string> ReadAllLines(const char* filename);
 
+// Lines and vector both come from resource, e.g. GetPuzzleArena()
+std::pmr::vector<std::pmr::string> ReadAllLines(std::istream& input, std::pmr::memory_resource* resource);
+
 //////////////////////////////////////////////////////////////////////////
 
 class ILineSource
@@ -18,6 +22,7 @@ public:
 	virtual ~ILineSource();
 	virtual const char* GetNextLine(const char* currentLine) const = 0;
 
+	// Files come from the puzzle input cache, so nothing is copied and nothing is read twice
 	static std::shared_ptr<ILineSource> CreateFromFile(const char* filename);
 	static std::shared_ptr<ILineSource> CreateFromString(const std::string& s);
 	static std::shared_ptr<ILineSource> CreateFromStream(std::istream &input);
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "Point2.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <assert.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define FLAT_POINT_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Open-addressing tables keyed by PackedPoint2, laid out like a Swiss table: one control byte
+// per slot holding 7 bits of the hash, probed sixteen slots at a time. Coordinates must fit in
+// int32. Clear keeps the storage, so a table can be reused across searches without allocating;
+// Clear and Erase do reset values that aren't trivially destructible so they free what they own.
+// Copies duplicate the whole table, tombstones included, like copying a std::set or std::map.
+namespace FlatPointGroup
+{
+	static constexpr size_t Width = 16;
+	static constexpr int8_t Empty = -128;
+	static constexpr int8_t Deleted = -2;
+
+	// Bit i is set when control byte i equals value
+	inline uint32_t Match(const int8_t* group, int8_t value)
+	{
+#if defined(FLAT_POINT_USE_SSE2)
+		__m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+		uint32_t bits = 0;
+		for (size_t i = 0; i < Width; i++)
+		{
+			bits |= (uint32_t)(group[i] == value) << i;
+		}
+		return bits;
+#endif
+	}
+
+	// Empty and deleted slots are the ones with the top bit set
+	inline uint32_t MatchFree(const int8_t* group)
+	{
+#if defined(FLAT_POINT_USE_SSE2)
+		return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+		uint32_t bits = 0;
+		for (size_t i = 0; i < Width; i++)
+		{
+			bits |= (uint32_t)(group[i] < 0) << i;
+		}
+		return bits;
+#endif
+	}
+
+	inline uint32_t MatchFull(const int8_t* group)
+	{
+		return ~MatchFree(group) & 0xffff;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename VALUE>
+class FlatPointTable
+{
+public:
+
+	FlatPointTable() = default;
+	FlatPointTable(const FlatPointTable& other);
+	FlatPointTable(FlatPointTable&& other) noexcept;
+	FlatPointTable& operator=(const FlatPointTable& other);
+	FlatPointTable& operator=(FlatPointTable&& other) noexcept;
+
+	size_t Size() const { return Count; }
+	bool Empty() const { return Count == 0; }
+	size_t Capacity() const { return Keys.size(); }
+
+	bool Contains(const Point2& p) const
+	{
+		return Find(PackedPoint2::FromPoint2(p).Key) != NotFound;
+	}
+
+	bool Erase(const Point2& p);
+	void Reserve(size_t count);
+	void Clear();
+
+protected:
+
+	static constexpr bool HasValues = !std::is_void_v<VALUE>;
+	using ValueStorage = std::conditional_t<HasValues, VALUE, char>;
+	static constexpr size_t NotFound = SIZE_MAX;
+
+	size_t Find(uint64_t key) const;
+	size_t FindOrInsert(uint64_t key, bool* inserted);
+
+	// Calls func(slot) for every live slot, a group of control bytes at a time
+	template <typename FUNC>
+	void ForEachSlot(FUNC func) const
+	{
+		for (size_t group = 0; group < Keys.size(); group += FlatPointGroup::Width)
+		{
+			for (uint32_t bits = FlatPointGroup::MatchFull(&Control[group]); bits != 0; bits &= bits - 1)
+			{
+				func(group + (size_t)std::countr_zero(bits));
+			}
+		}
+	}
+
+	std::vector<int8_t> Control;
+	std::vector<uint64_t> Keys;
+	// Not a vector so that bool values stay addressable
+	std::unique_ptr<ValueStorage[]> Values;
+
+private:
+
+	static uint64_t HashKey(uint64_t key) { return MixHash64(key); }
+	static int8_t ControlByte(uint64_t hash) { return (int8_t)(hash & 0x7f); }
+
+	void Rehash(size_t slotCount);
+	size_t FindFreeSlot(uint64_t hash) const;
+
+	size_t Count = 0;
+	size_t DeletedCount = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+class FlatPointSet : public FlatPointTable<void>
+{
+public:
+
+	// Returns true if the point was not already present
+	bool Insert(const Point2& p)
+	{
+		bool inserted = false;
+		FindOrInsert(PackedPoint2::FromPoint2(p).Key, &inserted);
+		return inserted;
+	}
+
+	template <typename FUNC>
+	void ForEach(FUNC func) const
+	{
+		ForEachSlot([&](size_t slot) { func(PackedPoint2{ Keys[slot] }.ToPoint2()); });
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename VALUE>
+class FlatPointMap : public FlatPointTable<VALUE>
+{
+public:
+
+	// Inserts a default-constructed value if the point is missing
+	VALUE& operator[](const Point2& p)
+	{
+		bool inserted = false;
+		return this->Values[this->FindOrInsert(PackedPoint2::FromPoint2(p).Key, &inserted)];
+	}
+
+	VALUE* Find(const Point2& p)
+	{
+		size_t slot = FlatPointTable<VALUE>::Find(PackedPoint2::FromPoint2(p).Key);
+		return (slot == this->NotFound) ? nullptr : &this->Values[slot];
+	}
+
+	const VALUE* Find(const Point2& p) const
+	{
+		size_t slot = FlatPointTable<VALUE>::Find(PackedPoint2::FromPoint2(p).Key);
+		return (slot == this->NotFound) ? nullptr : &this->Values[slot];
+	}
+
+	// Returns true if the point was not already present; an existing value is left alone
+	bool Insert(const Point2& p, const VALUE& value)
+	{
+		bool inserted = false;
+		size_t slot = this->FindOrInsert(PackedPoint2::FromPoint2(p).Key, &inserted);
+		if (inserted)
+		{
+			this->Values[slot] = value;
+		}
+		return inserted;
+	}
+
+	template <typename FUNC>
+	void ForEach(FUNC func)
+	{
+		this->ForEachSlot([&](size_t slot) { func(PackedPoint2{ this->Keys[slot] }.ToPoint2(), this->Values[slot]); });
+	}
+
+	template <typename FUNC>
+	void ForEach(FUNC func) const
+	{
+		this->ForEachSlot([&](size_t slot) { func(PackedPoint2{ this->Keys[slot] }.ToPoint2(), this->Values[slot]); });
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename VALUE>
+inline FlatPointTable<VALUE>::FlatPointTable(const FlatPointTable& other)
+	: Control(other.Control)
+	, Keys(other.Keys)
+	, Count(other.Count)
+	, DeletedCount(other.DeletedCount)
+{
+	// Sets never allocate values, so there's only something to copy for maps
+	if constexpr (HasValues)
+	{
+		if (other.Values)
+		{
+			Values = std::make_unique<ValueStorage[]>(other.Keys.size());
+			std::copy(other.Values.get(), other.Values.get() + other.Keys.size(), Values.get());
+		}
+	}
+}
+
+template <typename VALUE>
+inline FlatPointTable<VALUE>::FlatPointTable(FlatPointTable&& other) noexcept
+	: Control(std::move(other.Control))
+	, Keys(std::move(other.Keys))
+	, Values(std::move(other.Values))
+	, Count(std::exchange(other.Count, 0))
+	, DeletedCount(std::exchange(other.DeletedCount, 0))
+{
+	other.Control.clear();
+	other.Keys.clear();
+}
+
+template <typename VALUE>
+inline FlatPointTable<VALUE>& FlatPointTable<VALUE>::operator=(const FlatPointTable& other)
+{
+	if (this != &other)
+	{
+		*this = FlatPointTable(other);
+	}
+	return *this;
+}
+
+template <typename VALUE>
+inline FlatPointTable<VALUE>& FlatPointTable<VALUE>::operator=(FlatPointTable&& other) noexcept
+{
+	if (this != &other)
+	{
+		Control = std::move(other.Control);
+		Keys = std::move(other.Keys);
+		Values = std::move(other.Values);
+		Count = std::exchange(other.Count, 0);
+		DeletedCount = std::exchange(other.DeletedCount, 0);
+		other.Control.clear();
+		other.Keys.clear();
+	}
+	return *this;
+}
+
+template <typename VALUE>
+inline bool FlatPointTable<VALUE>::Erase(const Point2& p)
+{
+	size_t slot = Find(PackedPoint2::FromPoint2(p).Key);
+	if (slot == NotFound)
+		return false;
+
+	// Let go of anything the value owns now rather than whenever the slot is next used
+	if constexpr (HasValues && !std::is_trivially_destructible_v<VALUE>)
+	{
+		Values[slot] = VALUE{};
+	}
+	Control[slot] = FlatPointGroup::Deleted;
+	Count--;
+	DeletedCount++;
+	return true;
+}
+
+template <typename VALUE>
+inline void FlatPointTable<VALUE>::Reserve(size_t count)
+{
+	// Keep the table at most 7/8 full
+	size_t slotCount = std::bit_ceil(std::max<size_t>(count + (count / 7) + 1, FlatPointGroup::Width));
+	if (slotCount > Keys.size())
+	{
+		Rehash(slotCount);
+	}
+}
+
+template <typename VALUE>
+inline void FlatPointTable<VALUE>::Clear()
+{
+	if constexpr (HasValues && !std::is_trivially_destructible_v<VALUE>)
+	{
+		ForEachSlot([&](size_t slot) { Values[slot] = VALUE{}; });
+	}
+	std::fill(Control.begin(), Control.end(), FlatPointGroup::Empty);
+	Count = 0;
+	DeletedCount = 0;
+}
+
+template <typename VALUE>
+inline size_t FlatPointTable<VALUE>::Find(uint64_t key) const
+{
+	if (Keys.empty())
+		return NotFound;
+
+	// Triangular probing over groups visits every group of a power-of-two table
+	uint64_t hash = HashKey(key);
+	int8_t controlByte = ControlByte(hash);
+	size_t groupMask = (Keys.size() / FlatPointGroup::Width) - 1;
+	size_t group = (size_t)(hash >> 7) & groupMask;
+	for (size_t probe = 1; ; probe++)
+	{
+		const int8_t* groupControl = &Control[group * FlatPointGroup::Width];
+		for (uint32_t bits = FlatPointGroup::Match(groupControl, controlByte); bits != 0; bits &= bits - 1)
+		{
+			size_t slot = (group * FlatPointGroup::Width) + (size_t)std::countr_zero(bits);
+			if (Keys[slot] == key)
+				return slot;
+		}
+
+		if ((FlatPointGroup::Match(groupControl, FlatPointGroup::Empty) != 0) || (probe > groupMask))
+			return NotFound;
+
+		group = (group + probe) & groupMask;
+	}
+}
+
+template <typename VALUE>
+inline size_t FlatPointTable<VALUE>::FindOrInsert(uint64_t key, bool* inserted)
+{
+	size_t slot = Find(key);
+	if (slot != NotFound)
+	{
+		*inserted = false;
+		return slot;
+	}
+
+	if ((Count + DeletedCount + 1) * 8 > Keys.size() * 7)
+	{
+		// Grow if genuinely full, otherwise rehashing in place is enough to clear out tombstones
+		size_t slotCount = std::max<size_t>(Keys.size(), FlatPointGroup::Width);
+		if ((Count + 1) * 16 > slotCount * 7)
+		{
+			slotCount = std::max<size_t>(Keys.size() * 2, FlatPointGroup::Width);
+		}
+		Rehash(slotCount);
+	}
+
+	uint64_t hash = HashKey(key);
+	slot = FindFreeSlot(hash);
+	if (Control[slot] == FlatPointGroup::Deleted)
+	{
+		DeletedCount--;
+	}
+	Control[slot] = ControlByte(hash);
+	Keys[slot] = key;
+	if constexpr (HasValues)
+	{
+		Values[slot] = VALUE{};
+	}
+	Count++;
+	*inserted = true;
+	return slot;
+}
+
+template <typename VALUE>
+inline size_t FlatPointTable<VALUE>::FindFreeSlot(uint64_t hash) const
+{
+	size_t groupMask = (Keys.size() / FlatPointGroup::Width) - 1;
+	size_t group = (size_t)(hash >> 7) & groupMask;
+	for (size_t probe = 1; ; probe++)
+	{
+		uint32_t bits = FlatPointGroup::MatchFree(&Control[group * FlatPointGroup::Width]);
+		if (bits != 0)
+			return (group * FlatPointGroup::Width) + (size_t)std::countr_zero(bits);
+
+		group = (group + probe) & groupMask;
+	}
+}
+
+template <typename VALUE>
+inline void FlatPointTable<VALUE>::Rehash(size_t slotCount)
+{
+	assert(std::has_single_bit(slotCount) && (slotCount >= FlatPointGroup::Width));
+
+	std::vector<int8_t> oldControl = std::exchange(Control, std::vector<int8_t>(slotCount, FlatPointGroup::Empty));
+	std::vector<uint64_t> oldKeys = std::exchange(Keys, std::vector<uint64_t>(slotCount));
+	std::unique_ptr<ValueStorage[]> oldValues;
+	if constexpr (HasValues)
+	{
+		oldValues = std::exchange(Values, std::make_unique<ValueStorage[]>(slotCount));
+	}
+
+	for (size_t oldSlot = 0; oldSlot < oldKeys.size(); oldSlot++)
+	{
+		if (oldControl[oldSlot] < 0)
+			continue;
+
+		uint64_t hash = HashKey(oldKeys[oldSlot]);
+		size_t slot = FindFreeSlot(hash);
+		Control[slot] = ControlByte(hash);
+		Keys[slot] = oldKeys[oldSlot];
+		if constexpr (HasValues)
+		{
+			Values[slot] = std::move(oldValues[oldSlot]);
+		}
+	}
+	DeletedCount = 0;
+}
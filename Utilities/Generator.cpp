@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "Generator.h"
+
+namespace
+{
+	constexpr size_t FrameGranularity = 64;
+	constexpr size_t SizeClassCount = 32;
+	constexpr size_t MaxFramesPerClass = 64;
+
+	struct FreeFrame
+	{
+		FreeFrame* Next;
+	};
+
+	struct FramePool
+	{
+		FreeFrame* FreeLists[SizeClassCount] = {};
+		size_t FreeCounts[SizeClassCount] = {};
+
+		~FramePool()
+		{
+			for (FreeFrame* frame : FreeLists)
+			{
+				while (frame)
+				{
+					FreeFrame* next = frame->Next;
+					::operator delete(frame);
+					frame = next;
+				}
+			}
+		}
+	};
+
+	thread_local FramePool ThreadFramePool;
+
+	size_t SizeClass(size_t size)
+	{
+		return (size + FrameGranularity - 1) / FrameGranularity - 1;
+	}
+}
+
+void* GeneratorFramePool::Allocate(size_t size)
+{
+	size_t sizeClass = SizeClass(size);
+	if (sizeClass >= SizeClassCount)
+	{
+		return ::operator new(size);
+	}
+
+	FramePool& pool = ThreadFramePool;
+	if (FreeFrame* frame = pool.FreeLists[sizeClass])
+	{
+		pool.FreeLists[sizeClass] = frame->Next;
+		pool.FreeCounts[sizeClass]--;
+		return frame;
+	}
+
+	return ::operator new((sizeClass + 1) * FrameGranularity);
+}
+
+void GeneratorFramePool::Free(void* frame, size_t size)
+{
+	size_t sizeClass = SizeClass(size);
+	FramePool& pool = ThreadFramePool;
+	if ((sizeClass >= SizeClassCount) || (pool.FreeCounts[sizeClass] >= MaxFramesPerClass))
+	{
+		::operator delete(frame);
+		return;
+	}
+
+	FreeFrame* freeFrame = static_cast<FreeFrame*>(frame);
+	freeFrame->Next = pool.FreeLists[sizeClass];
+	pool.FreeLists[sizeClass] = freeFrame;
+	pool.FreeCounts[sizeClass]++;
+}
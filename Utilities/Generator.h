@@ -0,0 +1,197 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Coroutine frames are recycled through per-thread free lists bucketed by size
+namespace GeneratorFramePool
+{
+	void* Allocate(size_t size);
+	void Free(void* frame, size_t size);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class Generator : public std::ranges::view_interface<Generator<T>>
+{
+public:
+
+	struct promise_type
+	{
+		const T* Current = nullptr;
+		std::exception_ptr Exception;
+
+		Generator get_return_object() noexcept
+		{
+			return Generator{ std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		std::suspend_always final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		// The yielded value lives in the coroutine frame until it is resumed again
+		std::suspend_always yield_value(const T& value) noexcept
+		{
+			Current = std::addressof(value);
+			return {};
+		}
+
+		void return_void() const noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			Exception = std::current_exception();
+		}
+
+		template <typename U>
+		std::suspend_never await_transform(U&&) = delete;
+
+		static void* operator new(size_t size)
+		{
+			return GeneratorFramePool::Allocate(size);
+		}
+
+		static void operator delete(void* frame, size_t size) noexcept
+		{
+			GeneratorFramePool::Free(frame, size);
+		}
+	};
+
+	class Iterator
+	{
+	public:
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+
+		Iterator() = default;
+		explicit Iterator(std::coroutine_handle<promise_type> coroutine)
+			: Coroutine(coroutine)
+		{
+		}
+
+		Iterator(Iterator&&) noexcept = default;
+		Iterator& operator=(Iterator&&) noexcept = default;
+
+		Iterator& operator++()
+		{
+			Coroutine.resume();
+			RethrowIfFailed();
+			return *this;
+		}
+
+		void operator++(int)
+		{
+			++(*this);
+		}
+
+		const T& operator*() const
+		{
+			return *Coroutine.promise().Current;
+		}
+
+		const T* operator->() const
+		{
+			return Coroutine.promise().Current;
+		}
+
+		bool operator==(std::default_sentinel_t) const
+		{
+			return !Coroutine || Coroutine.done();
+		}
+
+	private:
+		friend class Generator;
+
+		void RethrowIfFailed() const
+		{
+			if (Coroutine.promise().Exception)
+			{
+				std::rethrow_exception(Coroutine.promise().Exception);
+			}
+		}
+
+		std::coroutine_handle<promise_type> Coroutine;
+	};
+
+	Generator() = default;
+
+	Generator(Generator&& other) noexcept
+		: Coroutine(std::exchange(other.Coroutine, {}))
+	{
+	}
+
+	Generator& operator=(Generator&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Destroy();
+			Coroutine = std::exchange(other.Coroutine, {});
+		}
+		return *this;
+	}
+
+	Generator(const Generator&) = delete;
+	Generator& operator=(const Generator&) = delete;
+
+	~Generator()
+	{
+		Destroy();
+	}
+
+	Iterator begin()
+	{
+		Iterator it{ Coroutine };
+		if (Coroutine)
+		{
+			Coroutine.resume();
+			it.RethrowIfFailed();
+		}
+		return it;
+	}
+
+	std::default_sentinel_t end() const
+	{
+		return std::default_sentinel;
+	}
+
+private:
+
+	explicit Generator(std::coroutine_handle<promise_type> coroutine)
+		: Coroutine(coroutine)
+	{
+	}
+
+	void Destroy()
+	{
+		if (Coroutine)
+		{
+			Coroutine.destroy();
+			Coroutine = {};
+		}
+	}
+
+	std::coroutine_handle<promise_type> Coroutine;
+};
+
+static_assert(std::input_iterator<Generator<int>::Iterator>);
+static_assert(std::ranges::input_range<Generator<int>>);
+static_assert(std::ranges::view<Generator<int>>);
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Murmur3's 64-bit finaliser: every input bit affects every output bit, so packed keys, grid
+// coordinates and weak hashes alike spread over all the bits of a table index
+constexpr uint64_t MixHash64(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ull;
+	key ^= key >> 33;
+	return key;
+}
+
+// std::hash has no specialisation for pairs, so unordered containers keyed on one need this:
+// std::unordered_map<std::pair<int64_t, int64_t>, int64_t, PairHash>
+struct PairHash
+{
+	template <typename FIRST, typename SECOND>
+	std::size_t operator()(const std::pair<FIRST, SECOND>& p) const noexcept
+	{
+		return (std::size_t)MixHash64(((uint64_t)std::hash<FIRST>{}(p.first) * 0x9e3779b97f4a7c15ull) + (uint64_t)std::hash<SECOND>{}(p.second));
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////
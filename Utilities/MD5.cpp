@@ -1,43 +1,736 @@
 #include "stdafx.h"
 #include "MD5.h"
-#include <Windows.h>
-#include <bcrypt.h>
+#include "CpuFeatures.h"
+#include "Parallel.h"
+
+#include <bit>
 #include <cassert>
+#include <charconv>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MD5_USE_SSE2 1
+#include <immintrin.h>
+#endif
+
+// MSVC allows AVX2 intrinsics anywhere. GCC and Clang need each function that uses them marked
+// for AVX2; the kernels are also flattened so every helper is inlined into that AVX2 code.
+#if defined(MD5_USE_SSE2)
+#define MD5_USE_AVX2 1
+#if defined(_MSC_VER)
+#define MD5_AVX2_TARGET
+#define MD5_AVX2_KERNEL
+#else
+#define MD5_AVX2_TARGET __attribute__((target("avx2")))
+#define MD5_AVX2_KERNEL __attribute__((target("avx2"), flatten))
+#if !defined(__clang__)
+// The shared helpers are declared taking AVX2 vectors but only ever inlined into the kernels
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+#endif
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// Chaining state after absorbing some whole 64-byte blocks of a message
+	struct HashPrefix
+	{
+		uint32_t State[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+		uint64_t Length = 0;
+	};
+
+	struct ScalarLanes
+	{
+		using Type = uint32_t;
+		static constexpr size_t Width = 1;
+
+		static Type Set1(uint32_t v) { return v; }
+		static Type Load(const uint32_t* words) { return words[0]; }
+		static void Store(Type v, uint32_t* words) { words[0] = v; }
+		static Type Add(Type a, Type b) { return a + b; }
+		static Type And(Type a, Type b) { return a & b; }
+		static Type Or(Type a, Type b) { return a | b; }
+		static Type Xor(Type a, Type b) { return a ^ b; }
+		static Type Not(Type a) { return ~a; }
+		template <int S> static Type Rotl(Type a) { return std::rotl(a, S); }
+		template <int S> static Type Shl(Type a) { return a << S; }
+		template <int S> static Type Shr(Type a) { return a >> S; }
+	};
+
+#if defined(MD5_USE_SSE2)
+	struct SSE2Lanes
+	{
+		using Type = __m128i;
+		static constexpr size_t Width = 4;
+
+		static Type Set1(uint32_t v) { return _mm_set1_epi32((int)v); }
+		static Type Load(const uint32_t* words) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(words)); }
+		static void Store(Type v, uint32_t* words) { _mm_storeu_si128(reinterpret_cast<__m128i*>(words), v); }
+		static Type Add(Type a, Type b) { return _mm_add_epi32(a, b); }
+		static Type And(Type a, Type b) { return _mm_and_si128(a, b); }
+		static Type Or(Type a, Type b) { return _mm_or_si128(a, b); }
+		static Type Xor(Type a, Type b) { return _mm_xor_si128(a, b); }
+		static Type Not(Type a) { return _mm_xor_si128(a, _mm_set1_epi32(-1)); }
+		template <int S> static Type Rotl(Type a) { return _mm_or_si128(_mm_slli_epi32(a, S), _mm_srli_epi32(a, 32 - S)); }
+		template <int S> static Type Shl(Type a) { return _mm_slli_epi32(a, S); }
+		template <int S> static Type Shr(Type a) { return _mm_srli_epi32(a, S); }
+	};
+#endif
+
+#if defined(MD5_USE_AVX2)
+	struct AVX2Lanes
+	{
+		using Type = __m256i;
+		static constexpr size_t Width = 8;
+
+		MD5_AVX2_TARGET static Type Set1(uint32_t v) { return _mm256_set1_epi32((int)v); }
+		MD5_AVX2_TARGET static Type Load(const uint32_t* words) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)); }
+		MD5_AVX2_TARGET static void Store(Type v, uint32_t* words) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), v); }
+		MD5_AVX2_TARGET static Type Add(Type a, Type b) { return _mm256_add_epi32(a, b); }
+		MD5_AVX2_TARGET static Type And(Type a, Type b) { return _mm256_and_si256(a, b); }
+		MD5_AVX2_TARGET static Type Or(Type a, Type b) { return _mm256_or_si256(a, b); }
+		MD5_AVX2_TARGET static Type Xor(Type a, Type b) { return _mm256_xor_si256(a, b); }
+		MD5_AVX2_TARGET static Type Not(Type a) { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+		template <int S> MD5_AVX2_TARGET static Type Rotl(Type a) { return _mm256_or_si256(_mm256_slli_epi32(a, S), _mm256_srli_epi32(a, 32 - S)); }
+		template <int S> MD5_AVX2_TARGET static Type Shl(Type a) { return _mm256_slli_epi32(a, S); }
+		template <int S> MD5_AVX2_TARGET static Type Shr(Type a) { return _mm256_srli_epi32(a, S); }
+	};
+#endif
+
+	//////////////////////////////////////////////////////////////////////////
+
+	template <typename L>
+	inline typename L::Type F(typename L::Type b, typename L::Type c, typename L::Type d)
+	{
+		return L::Xor(d, L::And(b, L::Xor(c, d)));
+	}
+
+	template <typename L>
+	inline typename L::Type G(typename L::Type b, typename L::Type c, typename L::Type d)
+	{
+		return L::Xor(c, L::And(d, L::Xor(b, c)));
+	}
+
+	template <typename L>
+	inline typename L::Type H(typename L::Type b, typename L::Type c, typename L::Type d)
+	{
+		return L::Xor(b, L::Xor(c, d));
+	}
+
+	template <typename L>
+	inline typename L::Type I(typename L::Type b, typename L::Type c, typename L::Type d)
+	{
+		return L::Xor(c, L::Or(b, L::Not(d)));
+	}
+
+	template <typename L, int S>
+	inline void Step(typename L::Type& a, typename L::Type b, typename L::Type f, typename L::Type m, uint32_t k)
+	{
+		a = L::Add(b, L::template Rotl<S>(L::Add(L::Add(a, f), L::Add(m, L::Set1(k)))));
+	}
+
+	template <typename L>
+	void Compress(typename L::Type state[4], const typename L::Type m[16])
+	{
+		typename L::Type a = state[0];
+		typename L::Type b = state[1];
+		typename L::Type c = state[2];
+		typename L::Type d = state[3];
+
+		Step<L, 7>(a, b, F<L>(b, c, d), m[0], 0xd76aa478);
+		Step<L, 12>(d, a, F<L>(a, b, c), m[1], 0xe8c7b756);
+		Step<L, 17>(c, d, F<L>(d, a, b), m[2], 0x242070db);
+		Step<L, 22>(b, c, F<L>(c, d, a), m[3], 0xc1bdceee);
+		Step<L, 7>(a, b, F<L>(b, c, d), m[4], 0xf57c0faf);
+		Step<L, 12>(d, a, F<L>(a, b, c), m[5], 0x4787c62a);
+		Step<L, 17>(c, d, F<L>(d, a, b), m[6], 0xa8304613);
+		Step<L, 22>(b, c, F<L>(c, d, a), m[7], 0xfd469501);
+		Step<L, 7>(a, b, F<L>(b, c, d), m[8], 0x698098d8);
+		Step<L, 12>(d, a, F<L>(a, b, c), m[9], 0x8b44f7af);
+		Step<L, 17>(c, d, F<L>(d, a, b), m[10], 0xffff5bb1);
+		Step<L, 22>(b, c, F<L>(c, d, a), m[11], 0x895cd7be);
+		Step<L, 7>(a, b, F<L>(b, c, d), m[12], 0x6b901122);
+		Step<L, 12>(d, a, F<L>(a, b, c), m[13], 0xfd987193);
+		Step<L, 17>(c, d, F<L>(d, a, b), m[14], 0xa679438e);
+		Step<L, 22>(b, c, F<L>(c, d, a), m[15], 0x49b40821);
+
+		Step<L, 5>(a, b, G<L>(b, c, d), m[1], 0xf61e2562);
+		Step<L, 9>(d, a, G<L>(a, b, c), m[6], 0xc040b340);
+		Step<L, 14>(c, d, G<L>(d, a, b), m[11], 0x265e5a51);
+		Step<L, 20>(b, c, G<L>(c, d, a), m[0], 0xe9b6c7aa);
+		Step<L, 5>(a, b, G<L>(b, c, d), m[5], 0xd62f105d);
+		Step<L, 9>(d, a, G<L>(a, b, c), m[10], 0x02441453);
+		Step<L, 14>(c, d, G<L>(d, a, b), m[15], 0xd8a1e681);
+		Step<L, 20>(b, c, G<L>(c, d, a), m[4], 0xe7d3fbc8);
+		Step<L, 5>(a, b, G<L>(b, c, d), m[9], 0x21e1cde6);
+		Step<L, 9>(d, a, G<L>(a, b, c), m[14], 0xc33707d6);
+		Step<L, 14>(c, d, G<L>(d, a, b), m[3], 0xf4d50d87);
+		Step<L, 20>(b, c, G<L>(c, d, a), m[8], 0x455a14ed);
+		Step<L, 5>(a, b, G<L>(b, c, d), m[13], 0xa9e3e905);
+		Step<L, 9>(d, a, G<L>(a, b, c), m[2], 0xfcefa3f8);
+		Step<L, 14>(c, d, G<L>(d, a, b), m[7], 0x676f02d9);
+		Step<L, 20>(b, c, G<L>(c, d, a), m[12], 0x8d2a4c8a);
+
+		Step<L, 4>(a, b, H<L>(b, c, d), m[5], 0xfffa3942);
+		Step<L, 11>(d, a, H<L>(a, b, c), m[8], 0x8771f681);
+		Step<L, 16>(c, d, H<L>(d, a, b), m[11], 0x6d9d6122);
+		Step<L, 23>(b, c, H<L>(c, d, a), m[14], 0xfde5380c);
+		Step<L, 4>(a, b, H<L>(b, c, d), m[1], 0xa4beea44);
+		Step<L, 11>(d, a, H<L>(a, b, c), m[4], 0x4bdecfa9);
+		Step<L, 16>(c, d, H<L>(d, a, b), m[7], 0xf6bb4b60);
+		Step<L, 23>(b, c, H<L>(c, d, a), m[10], 0xbebfbc70);
+		Step<L, 4>(a, b, H<L>(b, c, d), m[13], 0x289b7ec6);
+		Step<L, 11>(d, a, H<L>(a, b, c), m[0], 0xeaa127fa);
+		Step<L, 16>(c, d, H<L>(d, a, b), m[3], 0xd4ef3085);
+		Step<L, 23>(b, c, H<L>(c, d, a), m[6], 0x04881d05);
+		Step<L, 4>(a, b, H<L>(b, c, d), m[9], 0xd9d4d039);
+		Step<L, 11>(d, a, H<L>(a, b, c), m[12], 0xe6db99e5);
+		Step<L, 16>(c, d, H<L>(d, a, b), m[15], 0x1fa27cf8);
+		Step<L, 23>(b, c, H<L>(c, d, a), m[2], 0xc4ac5665);
+
+		Step<L, 6>(a, b, I<L>(b, c, d), m[0], 0xf4292244);
+		Step<L, 10>(d, a, I<L>(a, b, c), m[7], 0x432aff97);
+		Step<L, 15>(c, d, I<L>(d, a, b), m[14], 0xab9423a7);
+		Step<L, 21>(b, c, I<L>(c, d, a), m[5], 0xfc93a039);
+		Step<L, 6>(a, b, I<L>(b, c, d), m[12], 0x655b59c3);
+		Step<L, 10>(d, a, I<L>(a, b, c), m[3], 0x8f0ccc92);
+		Step<L, 15>(c, d, I<L>(d, a, b), m[10], 0xffeff47d);
+		Step<L, 21>(b, c, I<L>(c, d, a), m[1], 0x85845dd1);
+		Step<L, 6>(a, b, I<L>(b, c, d), m[8], 0x6fa87e4f);
+		Step<L, 10>(d, a, I<L>(a, b, c), m[15], 0xfe2ce6e0);
+		Step<L, 15>(c, d, I<L>(d, a, b), m[6], 0xa3014314);
+		Step<L, 21>(b, c, I<L>(c, d, a), m[13], 0x4e0811a1);
+		Step<L, 6>(a, b, I<L>(b, c, d), m[4], 0xf7537e82);
+		Step<L, 10>(d, a, I<L>(a, b, c), m[11], 0xbd3af235);
+		Step<L, 15>(c, d, I<L>(d, a, b), m[2], 0x2ad7d2bb);
+		Step<L, 21>(b, c, I<L>(c, d, a), m[9], 0xeb86d391);
+
+		state[0] = L::Add(state[0], a);
+		state[1] = L::Add(state[1], b);
+		state[2] = L::Add(state[2], c);
+		state[3] = L::Add(state[3], d);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	inline uint32_t ReadLittleEndian(const uint8_t* bytes)
+	{
+		uint32_t v;
+		memcpy(&v, bytes, sizeof(v));
+		if constexpr (std::endian::native == std::endian::big)
+		{
+			v = ((v & 0xff) << 24) | ((v & 0xff00) << 8) | ((v >> 8) & 0xff00) | (v >> 24);
+		}
+		return v;
+	}
+
+	inline void WriteLittleEndian(uint32_t v, uint8_t* bytes)
+	{
+		bytes[0] = (uint8_t)v;
+		bytes[1] = (uint8_t)(v >> 8);
+		bytes[2] = (uint8_t)(v >> 16);
+		bytes[3] = (uint8_t)(v >> 24);
+	}
+
+	// A message split into the blocks it can be read from directly and up to two padded tail blocks
+	struct PaddedMessage
+	{
+		const uint8_t* Data = nullptr;
+		size_t FullBlocks = 0;
+		size_t BlockCount = 0;
+		uint8_t Tail[128];
+
+		void Prepare(const uint8_t* data, size_t size, uint64_t prefixLength)
+		{
+			Data = data;
+			FullBlocks = size / 64;
+			size_t tailSize = size % 64;
+			size_t tailBlocks = (tailSize < 56) ? 1 : 2;
+			BlockCount = FullBlocks + tailBlocks;
+
+			uint8_t* lengthBytes = Tail + (tailBlocks * 64) - 8;
+			memcpy(Tail, data + (FullBlocks * 64), tailSize);
+			Tail[tailSize] = 0x80;
+			memset(Tail + tailSize + 1, 0, lengthBytes - (Tail + tailSize + 1));
+
+			uint64_t bitLength = ((uint64_t)size + prefixLength) * 8;
+			WriteLittleEndian((uint32_t)bitLength, lengthBytes);
+			WriteLittleEndian((uint32_t)(bitLength >> 32), lengthBytes + 4);
+		}
+
+		const uint8_t* Block(size_t block) const
+		{
+			return (block < FullBlocks) ? (Data + (block * 64)) : (Tail + ((block - FullBlocks) * 64));
+		}
+	};
+
+	template <typename L>
+	void HashLanes(const HashPrefix& prefix, const uint8_t* const* buffers, const size_t* bufferSizes, size_t count, uint8_t (*hashes)[16])
+	{
+		constexpr size_t Width = L::Width;
+
+		static const uint8_t EmptyBlock[64] = {};
+
+		PaddedMessage messages[Width];
+		const uint8_t* blocks[Width];
+		alignas(32) uint32_t words[Width];
+
+		for (size_t first = 0; first < count; first += Width)
+		{
+			size_t lanes = std::min(Width, count - first);
+			size_t maxBlocks = 0;
+			for (size_t lane = 0; lane < lanes; lane++)
+			{
+				messages[lane].Prepare(buffers[first + lane], bufferSizes[first + lane], prefix.Length);
+				maxBlocks = std::max(maxBlocks, messages[lane].BlockCount);
+			}
+
+			typename L::Type state[4];
+			for (size_t i = 0; i < 4; i++)
+			{
+				state[i] = L::Set1(prefix.State[i]);
+			}
+
+			for (size_t block = 0; block < maxBlocks; block++)
+			{
+				for (size_t lane = 0; lane < Width; lane++)
+				{
+					blocks[lane] = ((lane < lanes) && (block < messages[lane].BlockCount)) ? messages[lane].Block(block) : EmptyBlock;
+				}
+
+				typename L::Type m[16];
+				for (size_t word = 0; word < 16; word++)
+				{
+					for (size_t lane = 0; lane < Width; lane++)
+					{
+						words[lane] = ReadLittleEndian(blocks[lane] + (word * 4));
+					}
+					m[word] = L::Load(words);
+				}
+
+				Compress<L>(state, m);
+
+				// Lanes with shorter messages finish early; later blocks only churn their unused state
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					if (block + 1 == messages[lane].BlockCount)
+					{
+						for (size_t i = 0; i < 4; i++)
+						{
+							L::Store(state[i], words);
+							WriteLittleEndian(words[lane], hashes[first + lane] + (i * 4));
+						}
+					}
+				}
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	// Turns four nibbles (one per byte) into lowercase hex characters without a table or branches
+	template <typename L>
+	inline typename L::Type HexCharacters(typename L::Type nibbles)
+	{
+		typename L::Type isLetter = L::And(L::template Shr<4>(L::Add(nibbles, L::Set1(0x06060606))), L::Set1(0x01010101));
+		typename L::Type letterOffset = L::Add(L::Add(L::template Shl<5>(isLetter), L::template Shl<2>(isLetter)), L::Add(L::template Shl<1>(isLetter), isLetter));
+		return L::Add(L::Add(nibbles, L::Set1(0x30303030)), letterOffset);
+	}
+
+	// Builds the single padded block holding the 32 character hex encoding of a digest
+	template <typename L>
+	void HexEncodeBlock(const typename L::Type state[4], typename L::Type m[16])
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			typename L::Type high = HexCharacters<L>(L::And(L::template Shr<4>(state[i]), L::Set1(0x0f0f0f0f)));
+			typename L::Type low = HexCharacters<L>(L::And(state[i], L::Set1(0x0f0f0f0f)));
+
+			m[i * 2] = L::Or(
+				L::Or(L::And(high, L::Set1(0x000000ff)), L::And(L::template Shl<8>(high), L::Set1(0x00ff0000))),
+				L::Or(L::And(L::template Shl<8>(low), L::Set1(0x0000ff00)), L::And(L::template Shl<16>(low), L::Set1(0xff000000))));
+			m[(i * 2) + 1] = L::Or(
+				L::Or(L::And(L::template Shr<16>(high), L::Set1(0x000000ff)), L::And(L::template Shr<8>(high), L::Set1(0x00ff0000))),
+				L::Or(L::And(L::template Shr<8>(low), L::Set1(0x0000ff00)), L::And(low, L::Set1(0xff000000))));
+		}
+
+		m[8] = L::Set1(0x80);
+		for (size_t i = 9; i < 16; i++)
+		{
+			m[i] = L::Set1(0);
+		}
+		m[14] = L::Set1(32 * 8);
+	}
+
+	// Re-hashes the hex encoding of each digest in place, rounds times
+	template <typename L>
+	void ChainLanes(uint8_t (*hashes)[16], size_t count, int64_t rounds)
+	{
+		constexpr size_t Width = L::Width;
+		const HashPrefix initial;
+		alignas(32) uint32_t words[Width];
+
+		for (size_t first = 0; first < count; first += Width)
+		{
+			size_t lanes = std::min(Width, count - first);
+
+			typename L::Type state[4];
+			for (size_t i = 0; i < 4; i++)
+			{
+				for (size_t lane = 0; lane < Width; lane++)
+				{
+					words[lane] = (lane < lanes) ? ReadLittleEndian(hashes[first + lane] + (i * 4)) : 0;
+				}
+				state[i] = L::Load(words);
+			}
+
+			for (int64_t round = 0; round < rounds; round++)
+			{
+				typename L::Type m[16];
+				HexEncodeBlock<L>(state, m);
+				for (size_t i = 0; i < 4; i++)
+				{
+					state[i] = L::Set1(initial.State[i]);
+				}
+				Compress<L>(state, m);
+			}
+
+			for (size_t i = 0; i < 4; i++)
+			{
+				L::Store(state[i], words);
+				for (size_t lane = 0; lane < lanes; lane++)
+				{
+					WriteLittleEndian(words[lane], hashes[first + lane] + (i * 4));
+				}
+			}
+		}
+	}
+
+	HashPrefix AbsorbPrefix(const uint8_t* data, size_t size)
+	{
+		HashPrefix prefix;
+		for (size_t offset = 0; offset + 64 <= size; offset += 64)
+		{
+			uint32_t m[16];
+			for (size_t word = 0; word < 16; word++)
+			{
+				m[word] = ReadLittleEndian(data + offset + (word * 4));
+			}
+			Compress<ScalarLanes>(prefix.State, m);
+			prefix.Length += 64;
+		}
+		return prefix;
+	}
+
+#if defined(MD5_USE_AVX2)
+	// Only called once the CPU is known to support AVX2
+	MD5_AVX2_KERNEL void HashLanesAVX2(const HashPrefix& prefix, const uint8_t* const* buffers, const size_t* bufferSizes, size_t count, uint8_t (*hashes)[16])
+	{
+		HashLanes<AVX2Lanes>(prefix, buffers, bufferSizes, count, hashes);
+	}
+
+	MD5_AVX2_KERNEL void ChainLanesAVX2(uint8_t (*hashes)[16], size_t count, int64_t rounds)
+	{
+		ChainLanes<AVX2Lanes>(hashes, count, rounds);
+	}
+#endif
+
+	using HashLanesFunction = void (*)(const HashPrefix&, const uint8_t* const*, const size_t*, size_t, uint8_t (*)[16]);
+	using ChainLanesFunction = void (*)(uint8_t (*)[16], size_t, int64_t);
+
+	struct LaneKernel
+	{
+		HashLanesFunction Function;
+		ChainLanesFunction Chain;
+		size_t Width;
+	};
+
+	const LaneKernel& GetLaneKernel()
+	{
+		static const LaneKernel kernel = []() -> LaneKernel
+			{
+#if defined(MD5_USE_AVX2)
+				if (CpuSupportsAVX2())
+					return { &HashLanesAVX2, &ChainLanesAVX2, AVX2Lanes::Width };
+#endif
+#if defined(MD5_USE_SSE2)
+				return { &HashLanes<SSE2Lanes>, &ChainLanes<SSE2Lanes>, SSE2Lanes::Width };
+#else
+				return { &HashLanes<ScalarLanes>, &ChainLanes<ScalarLanes>, ScalarLanes::Width };
+#endif
+			}();
+		return kernel;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
 
 MD5::MD5()
 {
-	NTSTATUS createAlgo = BCryptOpenAlgorithmProvider(&Algorithm,
-		BCRYPT_MD5_ALGORITHM,
-		NULL,
-		0);
-	assert(createAlgo == 0);
-	(void)createAlgo;
 }
 
 MD5::~MD5()
 {
-	if (Algorithm)
-	{
-		NTSTATUS closeAlgo = BCryptCloseAlgorithmProvider(Algorithm, 0);
-		assert(closeAlgo == 0);
-		(void)closeAlgo;
-	}
 }
 
 bool MD5::Hash(const uint8_t* buffer, size_t bufferSize, uint8_t hash[16]) const
 {
-	NTSTATUS hashedOkay = BCryptHash(Algorithm,
-		NULL,
-		0,
-		(PUCHAR)buffer,
-		(ULONG)bufferSize,
-		(PUCHAR)hash,
-		16);
-	assert(hashedOkay == 0);
-	return (hashedOkay == 0);
+	PROFILE_SCOPE("MD5::Hash");
+	uint8_t (*hashes)[16] = reinterpret_cast<uint8_t (*)[16]>(hash);
+	HashLanes<ScalarLanes>(HashPrefix{}, &buffer, &bufferSize, 1, hashes);
+	return true;
 }
 
 bool MD5::Hash(const std::string& s, uint8_t hash[16]) const
 {
 	return Hash(reinterpret_cast<const uint8_t*>(s.data()), s.size(), hash);
 }
+
+void MD5::HashMany(const uint8_t* const* buffers, const size_t* bufferSizes, size_t count, uint8_t (*hashes)[16]) const
+{
+	PROFILE_SCOPE("MD5::HashMany");
+	const LaneKernel& kernel = GetLaneKernel();
+	if (count < kernel.Width)
+	{
+		HashLanes<ScalarLanes>(HashPrefix{}, buffers, bufferSizes, count, hashes);
+		return;
+	}
+	kernel.Function(HashPrefix{}, buffers, bufferSizes, count, hashes);
+}
+
+void MD5::HashMany(const std::string* strings, size_t count, uint8_t (*hashes)[16]) const
+{
+	constexpr size_t BatchSize = 64;
+	const uint8_t* buffers[BatchSize];
+	size_t bufferSizes[BatchSize];
+
+	for (size_t first = 0; first < count; first += BatchSize)
+	{
+		size_t batch = std::min(BatchSize, count - first);
+		for (size_t i = 0; i < batch; i++)
+		{
+			buffers[i] = reinterpret_cast<const uint8_t*>(strings[first + i].data());
+			bufferSizes[i] = strings[first + i].size();
+		}
+		HashMany(buffers, bufferSizes, batch, hashes + first);
+	}
+}
+
+size_t MD5::GetLaneCount()
+{
+	return GetLaneKernel().Width;
+}
+
+void MD5::HashChain(const std::string& seed, int64_t rounds, uint8_t hash[16]) const
+{
+	Hash(seed, hash);
+	ChainLanes<ScalarLanes>(reinterpret_cast<uint8_t (*)[16]>(hash), 1, rounds);
+}
+
+void MD5::HashChainMany(const std::string* seeds, size_t count, int64_t rounds, uint8_t (*hashes)[16]) const
+{
+	HashMany(seeds, count, hashes);
+
+	const LaneKernel& kernel = GetLaneKernel();
+	if (count < kernel.Width)
+	{
+		ChainLanes<ScalarLanes>(hashes, count, rounds);
+		return;
+	}
+	kernel.Chain(hashes, count, rounds);
+}
+
+void MD5::ToHex(const uint8_t* digest, char hex[32])
+{
+	static const auto table = []()
+		{
+			std::array<char[2], 256> pairs;
+			const char* digits = "0123456789abcdef";
+			for (size_t i = 0; i < pairs.size(); i++)
+			{
+				pairs[i][0] = digits[i >> 4];
+				pairs[i][1] = digits[i & 0xf];
+			}
+			return pairs;
+		}();
+
+	for (size_t i = 0; i < 16; i++)
+	{
+		memcpy(hex + (i * 2), table[digest[i]], 2);
+	}
+}
+
+std::string MD5::ToHex(const uint8_t* digest)
+{
+	std::string hex(32, '\0');
+	ToHex(digest, hex.data());
+	return hex;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+MD5HashChainWindow::MD5HashChainWindow(const std::string& salt, int64_t rounds)
+	: Salt(salt)
+	, Rounds(rounds)
+{
+}
+
+const uint8_t* MD5HashChainWindow::Get(int64_t index)
+{
+	assert(index >= FirstIndex);
+	while (index >= FirstIndex + (int64_t)Digests.size())
+	{
+		ComputeNextBatch();
+	}
+	return Digests[index - FirstIndex].data();
+}
+
+void MD5HashChainWindow::DiscardBefore(int64_t index)
+{
+	while ((FirstIndex < index) && !Digests.empty())
+	{
+		Digests.pop_front();
+		FirstIndex++;
+	}
+	FirstIndex = std::max(FirstIndex, index);
+}
+
+void MD5HashChainWindow::ComputeNextBatch()
+{
+	constexpr int64_t GroupSize = 64;
+	int64_t batchStart = FirstIndex + (int64_t)Digests.size();
+	int64_t batchSize = GroupSize * GetParallelThreadCount() * 4;
+
+	std::vector<std::array<uint8_t, 16>> batch(batchSize);
+	ParallelFor(batchSize / GroupSize, [&](int64_t group, int64_t)
+		{
+			std::string seeds[GroupSize];
+			for (int64_t i = 0; i < GroupSize; i++)
+			{
+				seeds[i] = Salt + std::to_string(batchStart + (group * GroupSize) + i);
+			}
+			Hasher.HashChainMany(seeds, GroupSize, Rounds, reinterpret_cast<uint8_t (*)[16]>(batch[group * GroupSize].data()));
+		});
+
+	Digests.insert(Digests.end(), batch.begin(), batch.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// Decimal nonce text that is bumped in place rather than reformatted for every value
+	struct DecimalCounter
+	{
+		char Digits[24];
+		size_t Length = 0;
+
+		explicit DecimalCounter(int64_t value)
+		{
+			Length = std::to_chars(Digits, Digits + sizeof(Digits), value).ptr - Digits;
+		}
+
+		void Increment()
+		{
+			for (size_t i = Length; i-- > 0;)
+			{
+				if (Digits[i] != '9')
+				{
+					Digits[i]++;
+					return;
+				}
+				Digits[i] = '0';
+			}
+			memmove(Digits + 1, Digits, Length);
+			Digits[0] = '1';
+			Length++;
+		}
+	};
+
+	void SearchNonceRange(const HashPrefix& prefix, const std::string& prefixTail, int64_t firstNonce, int64_t nonceCount,
+		const std::function<bool(const uint8_t*)>& predicate, std::vector<MD5::NonceMatch>* matches)
+	{
+		constexpr size_t BatchSize = 64;
+		const LaneKernel& kernel = GetLaneKernel();
+
+		uint8_t messages[BatchSize][128];
+		const uint8_t* buffers[BatchSize];
+		size_t bufferSizes[BatchSize];
+		uint8_t hashes[BatchSize][16];
+
+		for (size_t i = 0; i < BatchSize; i++)
+		{
+			memcpy(messages[i], prefixTail.data(), prefixTail.size());
+			buffers[i] = messages[i];
+		}
+
+		DecimalCounter counter(firstNonce);
+		for (int64_t batchStart = 0; batchStart < nonceCount; batchStart += BatchSize)
+		{
+			size_t batch = (size_t)std::min<int64_t>(BatchSize, nonceCount - batchStart);
+			for (size_t i = 0; i < batch; i++)
+			{
+				memcpy(messages[i] + prefixTail.size(), counter.Digits, counter.Length);
+				bufferSizes[i] = prefixTail.size() + counter.Length;
+				counter.Increment();
+			}
+
+			kernel.Function(prefix, buffers, bufferSizes, batch, hashes);
+
+			for (size_t i = 0; i < batch; i++)
+			{
+				if (predicate(hashes[i]))
+				{
+					MD5::NonceMatch match;
+					match.Nonce = firstNonce + batchStart + (int64_t)i;
+					memcpy(match.Digest, hashes[i], sizeof(match.Digest));
+					matches->push_back(match);
+				}
+			}
+		}
+	}
+}
+
+std::vector<MD5::NonceMatch> MD5::FindNonces(const std::string& prefix, const std::function<bool(const uint8_t*)>& predicate,
+	size_t matchCount, int64_t firstNonce) const
+{
+	assert(firstNonce >= 0);
+
+	constexpr int64_t ChunkSize = 1 << 16;
+
+	size_t fullBlockBytes = (prefix.size() / 64) * 64;
+	HashPrefix prefixState = AbsorbPrefix(reinterpret_cast<const uint8_t*>(prefix.data()), fullBlockBytes);
+	std::string prefixTail = prefix.substr(fullBlockBytes);
+
+	// Search in waves of chunks; once a wave completes every nonce below its end has been checked,
+	// so the lowest matches found so far are final
+	std::vector<NonceMatch> found;
+	int64_t chunksPerWave = GetParallelThreadCount() * 4;
+	for (int64_t waveStart = firstNonce; found.size() < matchCount; waveStart += chunksPerWave * ChunkSize)
+	{
+		std::vector<std::vector<NonceMatch>> chunkMatches(chunksPerWave);
+		ParallelFor(chunksPerWave, [&](int64_t chunk, int64_t)
+			{
+				SearchNonceRange(prefixState, prefixTail, waveStart + (chunk * ChunkSize), ChunkSize, predicate, &chunkMatches[chunk]);
+			});
+
+		for (const std::vector<NonceMatch>& matches : chunkMatches)
+		{
+			found.insert(found.end(), matches.begin(), matches.end());
+		}
+	}
+
+	found.resize(matchCount);
+	return found;
+}
+
+bool MD5::HasLeadingZeroNibbles(const uint8_t* digest, int64_t nibbles)
+{
+	for (int64_t i = 0; i < nibbles / 2; i++)
+	{
+		if (digest[i] != 0)
+			return false;
+	}
+	return ((nibbles % 2) == 0) || ((digest[nibbles / 2] & 0xf0) == 0);
+}
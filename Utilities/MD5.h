@@ -1,5 +1,11 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+#include <stddef.h>
 #include <stdint.h>
 
 class MD5
@@ -22,8 +28,51 @@ public:
 	bool Hash(const uint8_t* buffer, size_t bufferSize, uint8_t hash[16]) const;
 	bool Hash(const std::string &s, uint8_t hash[16]) const;
 
+	// Hashes independent messages in lockstep, one per SIMD lane (8 with AVX2, 4 with SSE2)
+	void HashMany(const uint8_t* const* buffers, const size_t* bufferSizes, size_t count, uint8_t (*hashes)[16]) const;
+	void HashMany(const std::string* strings, size_t count, uint8_t (*hashes)[16]) const;
+
+	static size_t GetLaneCount();
+
+	struct NonceMatch
+	{
+		int64_t Nonce;
+		uint8_t Digest[16];
+	};
+
+	// Hashes prefix + decimal nonce for nonces counting up from firstNonce across all cores and
+	// returns the first matchCount matches in ascending nonce order. The predicate is called concurrently.
+	std::vector<NonceMatch> FindNonces(const std::string& prefix, const std::function<bool(const uint8_t*)>& predicate,
+		size_t matchCount, int64_t firstNonce = 0) const;
+
+	static bool HasLeadingZeroNibbles(const uint8_t* digest, int64_t nibbles);
+
+	// Hashes seed, then re-hashes the lowercase hex of the digest another `rounds` times
+	void HashChain(const std::string& seed, int64_t rounds, uint8_t hash[16]) const;
+	void HashChainMany(const std::string* seeds, size_t count, int64_t rounds, uint8_t (*hashes)[16]) const;
+
+	static void ToHex(const uint8_t* digest, char hex[32]);
+	static std::string ToHex(const uint8_t* digest);
+};
+
+// Memoised hash chains of salt + index for sliding lookahead searches; indices are computed ahead
+// in parallel batches and kept until discarded
+class MD5HashChainWindow
+{
+public:
+
+	MD5HashChainWindow(const std::string& salt, int64_t rounds);
+
+	const uint8_t* Get(int64_t index);
+	void DiscardBefore(int64_t index);
+
 private:
 
-	void* Algorithm = 0;
+	void ComputeNextBatch();
 
+	MD5 Hasher;
+	std::string Salt;
+	int64_t Rounds;
+	int64_t FirstIndex = 0;
+	std::deque<std::array<uint8_t, 16>> Digests;
 };
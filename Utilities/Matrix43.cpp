@@ -0,0 +1,26 @@
+#include "stdafx.h"
+#include "Matrix43.h"
+
+const std::array<Matrix43, 24>& Matrix::AxisAlignedRotations()
+{
+	static const std::array<Matrix43, 24> rotations = []()
+		{
+			// Pick where X goes (6 ways) and where Y goes (4 ways); Z follows from the cross product
+			std::array<Matrix43, 24> result;
+			size_t count = 0;
+			for (const Vector3& i : Vector3::CardinalDirections())
+			{
+				for (const Vector3& j : Vector3::CardinalDirections())
+				{
+					if (Dot(i, j) == 0)
+					{
+						result[count++] = MakeRotation(i, j, Cross(i, j));
+					}
+				}
+			}
+			assert(count == result.size());
+			assert(result[0] == MakeIdentity());
+			return result;
+		}();
+	return rotations;
+}
@@ -2,6 +2,8 @@
 
 #include "Vector3.h"
 
+#include <array>
+
 struct Matrix43
 {
 	int64_t m00, m01, m02;
@@ -137,4 +139,7 @@ namespace Matrix
 		return inverse;
 	}
 
+	// The 24 proper rotations that map axes onto axes, identity first
+	const std::array<Matrix43, 24>& AxisAlignedRotations();
+
 }
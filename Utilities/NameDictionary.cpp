@@ -1,19 +1,324 @@
 #include "stdafx.h"
 #include "NameDictionary.h"
+#include "Hashing.h"
 
-int64_t NameDictionary::IdFromName(const std::string& name) const
+NameDictionary::NameDictionary()
 {
-	std::map<std::string, int64_t>::const_iterator existingId = NameToId.find(name);
-	if (existingId == NameToId.end())
+	for (std::atomic<std::string_view*>& segment : IdToName)
 	{
-		int64_t newId = NameToId.size();
-		existingId = NameToId.insert({ name, newId }).first;
-		IdToName.insert({ newId, name });
+		segment.store(nullptr, std::memory_order_relaxed);
 	}
-	return existingId->second;
 }
 
-std::string NameDictionary::NameFromId(int64_t id) const
+NameDictionary::~NameDictionary()
 {
-	return IdToName.at(id);
+	for (std::atomic<std::string_view*>& segment : IdToName)
+	{
+		delete[] segment.load(std::memory_order_relaxed);
+	}
+}
+
+namespace
+{
+	uint64_t PerfectSeed(uint16_t displacement)
+	{
+		return displacement * 0x9e3779b97f4a7c15ull;
+	}
+
+	// True for exactly the keys TryPackShortName produces: no zero byte below the highest set one
+	[[maybe_unused]] bool IsCanonicalPackedName(uint64_t packedName)
+	{
+		size_t length = (size_t)(std::bit_width(packedName) + 7) / 8;
+		for (size_t i = 0; i < length; i++)
+		{
+			if (((packedName >> (i * 8)) & 0xff) == 0)
+				return false;
+		}
+		return true;
+	}
+}
+
+int64_t NameDictionary::IdFromName(std::string_view name) const
+{
+	uint64_t packedName = 0;
+	if (TryPackShortName(name, &packedName))
+	{
+		return IdFromPackedName(packedName);
+	}
+
+	uint64_t hash = std::hash<std::string_view>{}(name);
+	if (!PerfectSlots.empty())
+	{
+		int64_t perfectId = FindPerfect(hash, name, false);
+		if (perfectId >= 0)
+		{
+			return perfectId;
+		}
+	}
+	return FindOrInsert(Shards, hash, name, false);
+}
+
+int64_t NameDictionary::IdFromPackedName(uint64_t packedName) const
+{
+	// Zero unpacks to the empty name, which never packs, so it must get its id the same way
+	if (packedName == 0)
+	{
+		return IdFromName({});
+	}
+
+	// Anything else would be interned under a key IdFromName never looks up for that name
+	assert(IsCanonicalPackedName(packedName));
+
+	if (!PerfectSlots.empty())
+	{
+		int64_t perfectId = FindPerfect(packedName, {}, true);
+		if (perfectId >= 0)
+		{
+			return perfectId;
+		}
+	}
+	return FindOrInsert(ShortShards, packedName, UnpackShortName(packedName), true);
+}
+
+std::string_view NameDictionary::NameFromId(int64_t id) const
+{
+	assert((id >= 0) && (id < Count.load(std::memory_order_acquire)));
+	return IdSlot(id);
+}
+
+int64_t NameDictionary::Size() const
+{
+	return Count.load(std::memory_order_acquire);
+}
+
+void NameDictionary::BuildPerfectHash()
+{
+	std::vector<PerfectSlot> entries((size_t)Size());
+	assert(entries.size() <= (size_t)INT32_MAX);
+	for (size_t id = 0; id < entries.size(); id++)
+	{
+		std::string_view name = IdSlot((int64_t)id);
+		PerfectSlot& entry = entries[id];
+		entry.Id = (int32_t)id;
+		entry.IsShort = TryPackShortName(name, &entry.Key);
+		if (!entry.IsShort)
+		{
+			entry.Key = std::hash<std::string_view>{}(name);
+		}
+	}
+
+	// Aim for a 50-80% full table, and give it more room if the displacement search gets stuck
+	size_t tableSize = std::bit_ceil(std::max<size_t>(entries.size() + entries.size() / 4, 16));
+	for (int attempt = 0; attempt < 4; attempt++, tableSize *= 2)
+	{
+		if (TryBuildPerfectHash(entries, tableSize))
+			return;
+	}
+
+	// Fall back to the sharded tables
+	PerfectDisplacements.clear();
+	PerfectSlots.clear();
+}
+
+bool NameDictionary::TryPackShortName(std::string_view name, uint64_t* packedName)
+{
+	if (name.empty() || (name.size() > sizeof(uint64_t)) || (name.find('\0') != std::string_view::npos))
+		return false;
+
+	uint64_t packed = 0;
+	memcpy(&packed, name.data(), name.size());
+	*packedName = packed;
+	return true;
+}
+
+std::string_view NameDictionary::UnpackShortName(const uint64_t& packedName)
+{
+	return { reinterpret_cast<const char*>(&packedName), (size_t)(std::bit_width(packedName) + 7) / 8 };
+}
+
+int64_t NameDictionary::FindOrInsert(std::array<Shard, ShardCount>& shards, uint64_t key, std::string_view name, bool isShort) const
+{
+	Shard& shard = shards[MixHash64(key) % ShardCount];
+	{
+		std::shared_lock<std::shared_mutex> readLock(shard.Mutex);
+		int64_t existingId = FindInShard(shard, key, name, isShort);
+		if (existingId >= 0)
+		{
+			return existingId;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> writeLock(shard.Mutex);
+	int64_t existingId = FindInShard(shard, key, name, isShort);
+	if (existingId >= 0)
+	{
+		return existingId;
+	}
+
+	int64_t newId = InsertName(name);
+	AddToShard(shard, key, newId);
+	return newId;
+}
+
+int64_t NameDictionary::FindInShard(const Shard& shard, uint64_t key, std::string_view name, bool isShort) const
+{
+	if (shard.Slots.empty())
+		return -1;
+
+	// The low bits picked the shard, so probe with the rest
+	size_t mask = shard.Slots.size() - 1;
+	for (size_t i = (MixHash64(key) / ShardCount) & mask; ; i = (i + 1) & mask)
+	{
+		const Slot& slot = shard.Slots[i];
+		if (slot.Id < 0)
+			return -1;
+
+		// A packed key is the whole name, so short names never need the string compare
+		if ((slot.Key == key) && (isShort || (IdSlot(slot.Id) == name)))
+			return slot.Id;
+	}
+}
+
+void NameDictionary::AddToShard(Shard& shard, uint64_t key, int64_t id) const
+{
+	if ((shard.Used + 1) * 4 > shard.Slots.size() * 3)
+	{
+		std::vector<Slot> oldSlots = std::exchange(shard.Slots, std::vector<Slot>(std::max<size_t>(shard.Slots.size() * 2, 16)));
+		shard.Used = 0;
+		for (const Slot& slot : oldSlots)
+		{
+			if (slot.Id >= 0)
+			{
+				AddToShard(shard, slot.Key, slot.Id);
+			}
+		}
+	}
+
+	size_t mask = shard.Slots.size() - 1;
+	size_t i = (MixHash64(key) / ShardCount) & mask;
+	while (shard.Slots[i].Id >= 0)
+	{
+		i = (i + 1) & mask;
+	}
+	shard.Slots[i] = { key, id };
+	shard.Used++;
+}
+
+int64_t NameDictionary::FindPerfect(uint64_t key, std::string_view name, bool isShort) const
+{
+	uint64_t mixed = MixHash64(key);
+	uint16_t displacement = PerfectDisplacements[mixed & (PerfectDisplacements.size() - 1)];
+	const PerfectSlot& slot = PerfectSlots[MixHash64(key ^ PerfectSeed(displacement)) & (PerfectSlots.size() - 1)];
+	if ((slot.Id < 0) || (slot.Key != key) || (slot.IsShort != isShort))
+		return -1;
+
+	if (!isShort && (IdSlot(slot.Id) != name))
+		return -1;
+
+	return slot.Id;
+}
+
+bool NameDictionary::TryBuildPerfectHash(const std::vector<PerfectSlot>& entries, size_t tableSize)
+{
+	// Hash and displace: group keys into buckets of about four, then place the biggest buckets
+	// first, trying displacements until every key in the bucket lands on a free slot
+	size_t bucketCount = std::bit_ceil(std::max<size_t>(entries.size() / 4, 1));
+	std::vector<std::vector<size_t>> buckets(bucketCount);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		buckets[MixHash64(entries[i].Key) & (bucketCount - 1)].push_back(i);
+	}
+
+	std::vector<size_t> bucketOrder(bucketCount);
+	std::iota(bucketOrder.begin(), bucketOrder.end(), size_t{ 0 });
+	std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+	PerfectDisplacements.assign(bucketCount, 0);
+	PerfectSlots.assign(tableSize, {});
+
+	static constexpr uint16_t MaxDisplacement = UINT16_MAX;
+	std::vector<size_t> placed;
+	for (size_t bucketIndex : bucketOrder)
+	{
+		const std::vector<size_t>& bucket = buckets[bucketIndex];
+		if (bucket.empty())
+			break;
+
+		uint16_t displacement = 0;
+		for (; displacement < MaxDisplacement; displacement++)
+		{
+			placed.clear();
+			for (size_t entryIndex : bucket)
+			{
+				size_t slotIndex = MixHash64(entries[entryIndex].Key ^ PerfectSeed(displacement)) & (tableSize - 1);
+				if ((PerfectSlots[slotIndex].Id >= 0) || (std::find(placed.begin(), placed.end(), slotIndex) != placed.end()))
+					break;
+
+				placed.push_back(slotIndex);
+			}
+
+			if (placed.size() == bucket.size())
+				break;
+		}
+
+		// Identical keys (a long name whose hash collides with another) can never separate
+		if (displacement == MaxDisplacement)
+			return false;
+
+		PerfectDisplacements[bucketIndex] = displacement;
+		for (size_t i = 0; i < bucket.size(); i++)
+		{
+			PerfectSlots[placed[i]] = entries[bucket[i]];
+		}
+	}
+	return true;
+}
+
+int64_t NameDictionary::InsertName(std::string_view name) const
+{
+	std::lock_guard<std::mutex> insertLock(InsertMutex);
+
+	int64_t newId = Count.load(std::memory_order_relaxed);
+	IdSlot(newId) = CopyToArena(name);
+	Count.store(newId + 1, std::memory_order_release);
+	return newId;
+}
+
+std::string_view NameDictionary::CopyToArena(std::string_view name) const
+{
+	// There may be no block to point into yet, and memcpy mustn't be given a null pointer
+	if (name.empty())
+		return {};
+
+	if (name.size() > ArenaRemaining)
+	{
+		size_t blockSize = std::max(ArenaBlockSize, name.size());
+		ArenaBlocks.emplace_back(std::make_unique<char[]>(blockSize));
+		ArenaCursor = ArenaBlocks.back().get();
+		ArenaRemaining = blockSize;
+	}
+
+	char* copy = ArenaCursor;
+	memcpy(copy, name.data(), name.size());
+	ArenaCursor += name.size();
+	ArenaRemaining -= name.size();
+	return { copy, name.size() };
+}
+
+std::string_view& NameDictionary::IdSlot(int64_t id) const
+{
+	// Segment k holds FirstSegmentSize << k ids
+	size_t block = ((size_t)id / FirstSegmentSize) + 1;
+	size_t segmentIndex = std::bit_width(block) - 1;
+	size_t segmentStart = FirstSegmentSize * ((size_t{ 1 } << segmentIndex) - 1);
+	assert(segmentIndex < SegmentCount);
+
+	std::string_view* segment = IdToName[segmentIndex].load(std::memory_order_acquire);
+	if (segment == nullptr)
+	{
+		// Only reached by InsertName, which holds InsertMutex
+		segment = new std::string_view[FirstSegmentSize << segmentIndex];
+		IdToName[segmentIndex].store(segment, std::memory_order_release);
+	}
+	return segment[(size_t)id - segmentStart];
 }
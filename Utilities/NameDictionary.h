@@ -1,19 +1,101 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
-#include <map>
+#include <string_view>
+#include <vector>
 #include <stdint.h>
 
+// Interns names to dense ids (0, 1, 2, ... in order of first sight). Safe to call from several
+// threads at once: lookups of existing names only take a shared lock on one shard, and inserts
+// are serialised. Each name is stored once in an arena; the shard hash tables only hold
+// (key, id) pairs. Names of up to 8 bytes are keyed by their packed bytes, so looking them up
+// never touches the string data. Views returned by NameFromId stay valid for the lifetime of the
+// dictionary.
 class NameDictionary
 {
 public:
 
-	int64_t IdFromName(const std::string& name) const;
-	std::string NameFromId(int64_t id) const;
+	NameDictionary();
+	NameDictionary(const NameDictionary&) = delete;
+	NameDictionary& operator=(const NameDictionary&) = delete;
+	~NameDictionary();
+
+	int64_t IdFromName(std::string_view name) const;
+	// packedName must come from TryPackShortName, or be zero for the empty name
+	int64_t IdFromPackedName(uint64_t packedName) const;
+	std::string_view NameFromId(int64_t id) const;
+	int64_t Size() const;
+
+	// Builds a collision-free table over the names interned so far, so later lookups of those
+	// names take one probe and no lock. Names added afterwards use the sharded tables as usual.
+	// Must not run concurrently with any other call.
+	void BuildPerfectHash();
+
+	// Names of 1-8 bytes without embedded zeros pack little-endian into a uint64_t
+	static bool TryPackShortName(std::string_view name, uint64_t* packedName);
+
+	// The view points into packedName itself, so it's only valid while that variable is; a
+	// temporary would dangle straight away
+	static std::string_view UnpackShortName(const uint64_t& packedName);
+	static std::string_view UnpackShortName(const uint64_t&&) = delete;
 
 private:
 
-	//#TODO: make this thread safe, just in case we want to thread any puzzles in future
-	mutable std::map<int64_t, std::string> IdToName;
-	mutable std::map<std::string, int64_t> NameToId;
+	static constexpr size_t ShardCount = 16;
+	static constexpr size_t FirstSegmentSize = 64;
+	static constexpr size_t SegmentCount = 40;
+	static constexpr size_t ArenaBlockSize = 64 * 1024;
+
+	// Open addressing with linear probing; Id is -1 for empty slots. Key is the packed name for
+	// short names and the string hash otherwise.
+	struct Slot
+	{
+		uint64_t Key = 0;
+		int64_t Id = -1;
+	};
+
+	struct PerfectSlot
+	{
+		uint64_t Key = 0;
+		int32_t Id = -1;
+		bool IsShort = false;
+	};
+
+	struct Shard
+	{
+		std::shared_mutex Mutex;
+		std::vector<Slot> Slots;
+		size_t Used = 0;
+	};
+
+	int64_t FindOrInsert(std::array<Shard, ShardCount>& shards, uint64_t key, std::string_view name, bool isShort) const;
+	int64_t FindInShard(const Shard& shard, uint64_t key, std::string_view name, bool isShort) const;
+	void AddToShard(Shard& shard, uint64_t key, int64_t id) const;
+	int64_t FindPerfect(uint64_t key, std::string_view name, bool isShort) const;
+	bool TryBuildPerfectHash(const std::vector<PerfectSlot>& entries, size_t tableSize);
+	int64_t InsertName(std::string_view name) const;
+	std::string_view CopyToArena(std::string_view name) const;
+	std::string_view& IdSlot(int64_t id) const;
+
+	mutable std::array<Shard, ShardCount> Shards;
+	mutable std::array<Shard, ShardCount> ShortShards;
+
+	// Hash-and-displace table from BuildPerfectHash; empty until then
+	std::vector<uint16_t> PerfectDisplacements;
+	std::vector<PerfectSlot> PerfectSlots;
+
+	// Everything below is only written while holding InsertMutex
+	mutable std::mutex InsertMutex;
+	mutable std::vector<std::unique_ptr<char[]>> ArenaBlocks;
+	mutable char* ArenaCursor = nullptr;
+	mutable size_t ArenaRemaining = 0;
+
+	// Id to name segments double in size so published entries never move
+	mutable std::array<std::atomic<std::string_view*>, SegmentCount> IdToName;
+	mutable std::atomic<int64_t> Count = 0;
 };
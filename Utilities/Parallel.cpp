@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "Parallel.h"
+#include "AllocationTracking.h"
+#include "PuzzleArena.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	thread_local bool OnPoolWorker = false;
+
+	// Marks the calling thread as running pool work until the scope ends
+	class PoolWorkerScope
+	{
+	public:
+		PoolWorkerScope()
+			: m_previous(std::exchange(OnPoolWorker, true))
+		{
+		}
+
+		~PoolWorkerScope()
+		{
+			OnPoolWorker = m_previous;
+		}
+
+	private:
+		bool m_previous;
+	};
+}
+
+int64_t GetParallelThreadCount()
+{
+	return std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ParallelFor(int64_t count, const std::function<void(int64_t, int64_t)>& body)
+{
+	int64_t threadCount = OnPoolWorker ? 1 : std::min(GetParallelThreadCount(), count);
+	if (threadCount <= 1)
+	{
+		for (int64_t i = 0; i < count; i++)
+		{
+			body(i, 0);
+		}
+		return;
+	}
+
+	std::atomic<int64_t> nextIndex = 0;
+	AllocationScope* allocationScope = GetCurrentAllocationScope();
+	std::pmr::memory_resource* arena = GetPuzzleArena();
+	auto worker = [&](int64_t threadIndex)
+		{
+			PoolWorkerScope poolWorker;
+			SetCurrentAllocationScope(allocationScope);
+			SetPuzzleArena(arena);
+			for (int64_t i = nextIndex++; i < count; i = nextIndex++)
+			{
+				body(i, threadIndex);
+			}
+		};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (int64_t t = 1; t < threadCount; t++)
+	{
+		threads.emplace_back(worker, t);
+	}
+	worker(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+void ParallelForWorkStealing(int64_t count, const std::function<void(int64_t, int64_t)>& body, int64_t threadCount)
+{
+	threadCount = OnPoolWorker ? 1 : std::min((threadCount > 0) ? threadCount : GetParallelThreadCount(), count);
+	if (threadCount <= 1)
+	{
+		for (int64_t i = 0; i < count; i++)
+		{
+			body(i, 0);
+		}
+		return;
+	}
+
+	struct WorkQueue
+	{
+		std::mutex Mutex;
+		std::deque<int64_t> Indices;
+	};
+
+	std::vector<WorkQueue> queues(threadCount);
+	for (int64_t i = 0; i < count; i++)
+	{
+		queues[i % threadCount].Indices.push_back(i);
+	}
+
+	auto popOwn = [&](int64_t threadIndex, int64_t* index)
+		{
+			WorkQueue& queue = queues[threadIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (queue.Indices.empty())
+				return false;
+
+			*index = queue.Indices.front();
+			queue.Indices.pop_front();
+			return true;
+		};
+
+	auto steal = [&](int64_t threadIndex, int64_t* index)
+		{
+			for (int64_t offset = 1; offset < threadCount; offset++)
+			{
+				WorkQueue& victim = queues[(threadIndex + offset) % threadCount];
+				std::lock_guard<std::mutex> lock(victim.Mutex);
+				if (!victim.Indices.empty())
+				{
+					*index = victim.Indices.back();
+					victim.Indices.pop_back();
+					return true;
+				}
+			}
+			return false;
+		};
+
+	// Nothing is ever pushed after the start, so a failed steal means all work has been claimed
+	AllocationScope* allocationScope = GetCurrentAllocationScope();
+	std::pmr::memory_resource* arena = GetPuzzleArena();
+	auto worker = [&](int64_t threadIndex)
+		{
+			PoolWorkerScope poolWorker;
+			SetCurrentAllocationScope(allocationScope);
+			SetPuzzleArena(arena);
+			int64_t index = 0;
+			while (popOwn(threadIndex, &index) || steal(threadIndex, &index))
+			{
+				body(index, threadIndex);
+			}
+		};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (int64_t t = 1; t < threadCount; t++)
+	{
+		threads.emplace_back(worker, t);
+	}
+	worker(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <functional>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+int64_t GetParallelThreadCount();
+
+// Runs body(index, threadIndex) for every index in [0, count) across all cores. Indices are
+// handed out one at a time from a shared counter, so uneven work items balance themselves.
+// Worker threads share the caller's AllocationScope. Called from the body of another parallel
+// loop that has its own threads, it runs on the calling thread so nested loops don't multiply
+// the thread count; the same goes for ParallelForWorkStealing.
+void ParallelFor(int64_t count, const std::function<void(int64_t, int64_t)>& body);
+
+// Like ParallelFor, but indices are dealt round-robin onto per-thread queues up front. Each
+// thread works through its own queue from the front and, once that is empty, steals from the
+// back of the others. Put the most expensive indices first to get longest-first scheduling.
+// A threadCount of zero means one thread per core.
+void ParallelForWorkStealing(int64_t count, const std::function<void(int64_t, int64_t)>& body, int64_t threadCount = 0);
+
+//////////////////////////////////////////////////////////////////////////
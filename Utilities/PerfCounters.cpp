@@ -0,0 +1,132 @@
+#include "stdafx.h"
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(__linux__)
+	struct CounterConfig
+	{
+		uint32_t Type;
+		uint64_t Config;
+	};
+
+	// In the same order as the fields of PerfCounterValues
+	constexpr CounterConfig Configs[] =
+	{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+	};
+
+	int OpenCounter(const CounterConfig& config)
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = config.Type;
+		attr.config = config.Config;
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = (config.Type == PERF_TYPE_HARDWARE) ? 1 : 0;
+		attr.exclude_hv = 1;
+		// With more events than the PMU has slots the kernel multiplexes them, so each one
+		// only counts for part of the time; these let Stop() scale the count back up.
+		// A group would avoid that, but groups can't be read while inherit is set.
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+PerfCounters::PerfCounters()
+{
+	for (int i = 0; i < CounterCount; i++)
+	{
+#if defined(__linux__)
+		m_fds[i] = OpenCounter(Configs[i]);
+#else
+		m_fds[i] = -1;
+#endif
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+	for (int fd : m_fds)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+#endif
+}
+
+bool PerfCounters::IsAvailable() const
+{
+	return std::any_of(std::begin(m_fds), std::end(m_fds), [](int fd) { return fd >= 0; });
+}
+
+void PerfCounters::Start()
+{
+#if defined(__linux__)
+	for (int fd : m_fds)
+	{
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+PerfCounterValues PerfCounters::Stop()
+{
+	int64_t counts[CounterCount];
+	for (int i = 0; i < CounterCount; i++)
+	{
+		counts[i] = -1;
+#if defined(__linux__)
+		if (m_fds[i] < 0)
+			continue;
+
+		ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		// Laid out as requested by read_format: value, time enabled, time running
+		uint64_t reading[3] = {};
+		if (read(m_fds[i], reading, sizeof(reading)) != (ssize_t)sizeof(reading))
+			continue;
+
+		const uint64_t value = reading[0];
+		const uint64_t enabled = reading[1];
+		const uint64_t running = reading[2];
+		if (running == 0)
+			continue; // Never got onto the PMU, so there's nothing to scale
+
+		counts[i] = (running < enabled)
+			? (int64_t)((double)value * ((double)enabled / (double)running))
+			: (int64_t)value;
+#endif
+	}
+
+	PerfCounterValues values;
+	values.Cycles = counts[0];
+	values.Instructions = counts[1];
+	values.CacheMisses = counts[2];
+	values.BranchMisses = counts[3];
+	values.PageFaults = counts[4];
+	return values;
+}
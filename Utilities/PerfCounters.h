@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Totals over one measured region, scaled up when the kernel multiplexed the counters.
+// A count of -1 means the counter couldn't be opened or was never scheduled.
+struct PerfCounterValues
+{
+	int64_t Cycles = -1;
+	int64_t Instructions = -1;
+	int64_t CacheMisses = -1;
+	int64_t BranchMisses = -1;
+	int64_t PageFaults = -1;
+};
+
+// Counts hardware and software events for the calling thread and any threads it starts while
+// counting, using perf_event_open. Only Linux has it; elsewhere every counter is unavailable.
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// False if none of the counters could be opened, e.g. because of perf_event_paranoid
+	bool IsAvailable() const;
+
+	void Start();
+	PerfCounterValues Stop();
+
+private:
+	static constexpr int CounterCount = 5;
+	int m_fds[CounterCount];
+};
+
+//////////////////////////////////////////////////////////////////////////
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "Hashing.h"
+
+#include <compare>
 #include <functional>
 #include <vector>
 #include <map>
 #include <stdint.h>
+#include <assert.h>
 
 struct Point2
 {
@@ -103,9 +107,57 @@ struct std::hash<Point2>
 {
 	std::size_t operator()(const Point2& v) const noexcept
 	{
-		size_t hash = std::hash<decltype(v.X)>{}(v.X);
-		hash = std::hash<decltype(v.Y)>{}(v.Y) ^ (hash >> 16 | hash << 48);
-		return hash;
+		return (std::size_t)MixHash64(((uint64_t)v.X * 0x9e3779b97f4a7c15ull) + (uint64_t)v.Y);
+	}
+};
+
+// A Point2 whose coordinates fit in int32, packed as X in the low half and Y in the high half
+struct PackedPoint2
+{
+	uint64_t Key = 0;
+
+	// Same order as Point2, X then Y as signed values, not the order of the packed keys
+	constexpr std::strong_ordering operator<=>(const PackedPoint2& other) const
+	{
+		if (std::strong_ordering byX = X() <=> other.X(); byX != 0)
+			return byX;
+		return Y() <=> other.Y();
+	}
+	bool operator==(const PackedPoint2&) const = default;
+
+	static constexpr bool Fits(const Point2& p)
+	{
+		return (p.X >= INT32_MIN) && (p.X <= INT32_MAX) && (p.Y >= INT32_MIN) && (p.Y <= INT32_MAX);
+	}
+
+	static constexpr PackedPoint2 FromPoint2(const Point2& p)
+	{
+		assert(Fits(p));
+		return PackedPoint2{ (uint64_t)(uint32_t)(int32_t)p.X | ((uint64_t)(uint32_t)(int32_t)p.Y << 32) };
+	}
+
+	constexpr int32_t X() const
+	{
+		return (int32_t)(uint32_t)Key;
+	}
+
+	constexpr int32_t Y() const
+	{
+		return (int32_t)(uint32_t)(Key >> 32);
+	}
+
+	constexpr Point2 ToPoint2() const
+	{
+		return Point2{ X(), Y() };
+	}
+};
+
+template <>
+struct std::hash<PackedPoint2>
+{
+	std::size_t operator()(const PackedPoint2& v) const noexcept
+	{
+		return (std::size_t)MixHash64(v.Key);
 	}
 };
 
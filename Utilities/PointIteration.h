@@ -1,19 +1,27 @@
 #pragma once
 #include "Point2.h"
 
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <vector>
+#include <assert.h>
+
 //////////////////////////////////////////////////////////////////////////
 
+// Bresenham stepping, so lines at any angle are supported; axis-aligned and 45 degree lines
+// never touch the error term
 struct LineIterator
 {
 	using value_type = Point2;
 	using difference_type = ptrdiff_t;
 
-	Point2 Begin;
-	Point2 End;
 	Point2 Current;
+	Point2 Step;
+	Point2 Delta;
+	int64_t Error = 0;
+	int64_t Remaining = 0;
 
-	Point2 Direction;
-	
 	LineIterator& operator++()
 	{
 		NextLinePoint();
@@ -41,14 +49,26 @@ private:
 
 	void NextLinePoint()
 	{
-		assert(Current != End);
-		Current = Current + Direction;
+		assert(Remaining > 0);
+		Remaining--;
+
+		int64_t error2 = 2 * Error;
+		if (error2 >= Delta.Y)
+		{
+			Error += Delta.Y;
+			Current.X += Step.X;
+		}
+		if (error2 <= Delta.X)
+		{
+			Error += Delta.X;
+			Current.Y += Step.Y;
+		}
 	}
 };
 
 inline bool operator==(const LineIterator& a, const LineIterator& b)
 {
-	return a.Current == b.Current;
+	return a.Remaining == b.Remaining;
 }
 
 inline bool operator!=(const LineIterator& a, const LineIterator& b)
@@ -56,7 +76,7 @@ inline bool operator!=(const LineIterator& a, const LineIterator& b)
 	return !(a == b);
 }
 
-static_assert(std::input_or_output_iterator<LineIterator>);
+static_assert(std::forward_iterator<LineIterator>);
 
 struct LineInclusiveRange
 {
@@ -71,31 +91,62 @@ struct LineInclusiveRange
 
 	LineIterator begin() const
 	{
-		Point2 direction = GetDirection();
-		return { First, Last + direction, First, direction};
+		Point2 delta = GetDelta();
+		return { First, GetStep(), delta, delta.X + delta.Y, size() };
 	}
 
 	LineIterator end() const
 	{
-		Point2 direction = GetDirection();
-		return { First, Last + direction, Last + direction, direction };
+		return { Last, GetStep(), GetDelta(), 0, 0 };
 	}
 
-private:
-	Point2 GetDirection() const
+	int64_t size() const
+	{
+		return std::max(abs(Last.X - First.X), abs(Last.Y - First.Y)) + 1;
+	}
+
+	bool IsConstantStep() const
+	{
+		Point2 delta = GetDelta();
+		return (delta.X == 0) || (delta.Y == 0) || (delta.X == -delta.Y);
+	}
+
+	// Visits every point without going through the iterator, using a fixed stride where possible
+	template <typename FUNC>
+	void ForEach(FUNC&& func) const
 	{
-		if (First.X == Last.X)
+		if (IsConstantStep())
 		{
-			return (First.Y < Last.Y) ? Point2::Down() : Point2::Up();
+			Point2 step = GetStep();
+			Point2 current = First;
+			for (int64_t remaining = size(); remaining > 0; remaining--, current += step)
+			{
+				func(current);
+			}
 		}
 		else
 		{
-			return (First.X < Last.X) ? Point2::Right() : Point2::Left();
+			for (const Point2& p : *this)
+			{
+				func(p);
+			}
 		}
 	}
+
+private:
+	Point2 GetStep() const
+	{
+		return { (First.X < Last.X) ? 1 : ((First.X > Last.X) ? -1 : 0),
+			(First.Y < Last.Y) ? 1 : ((First.Y > Last.Y) ? -1 : 0) };
+	}
+
+	Point2 GetDelta() const
+	{
+		return { abs(Last.X - First.X), -abs(Last.Y - First.Y) };
+	}
 };
 
-static_assert(std::ranges::input_range<LineInclusiveRange>);
+static_assert(std::ranges::forward_range<LineInclusiveRange>);
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -156,6 +207,13 @@ inline bool operator!=(const GridIterator& a, const GridIterator& b)
 
 static_assert(std::input_or_output_iterator<GridIterator>);
 
+struct GridRow
+{
+	int64_t Y;
+	int64_t BeginX;
+	int64_t EndX;
+};
+
 struct GridRange
 {
 	Point2 Begin;
@@ -176,6 +234,42 @@ struct GridRange
 	{
 		return { Begin, End, { Begin.X, End.Y } };
 	}
+
+	int64_t size() const
+	{
+		return std::max<int64_t>(End.X - Begin.X, 0) * std::max<int64_t>(End.Y - Begin.Y, 0);
+	}
+
+	// Hands out each row as a contiguous [BeginX, EndX) span instead of one point at a time
+	template <typename FUNC>
+	void ForEachRow(FUNC&& func) const
+	{
+		if (Begin.X >= End.X)
+			return;
+
+		for (int64_t y = Begin.Y; y < End.Y; y++)
+		{
+			func(GridRow{ y, Begin.X, End.X });
+		}
+	}
+
+	// Bulk materialisation into structure-of-arrays form, one vectorisable fill per row
+	void Materialise(std::vector<int64_t>* xs, std::vector<int64_t>* ys) const
+	{
+		xs->resize(size());
+		ys->resize(size());
+
+		int64_t* x = xs->data();
+		int64_t* y = ys->data();
+		ForEachRow([&](const GridRow& row)
+			{
+				int64_t width = row.EndX - row.BeginX;
+				std::iota(x, x + width, row.BeginX);
+				std::fill(y, y + width, row.Y);
+				x += width;
+				y += width;
+			});
+	}
 };
 
 static_assert(std::ranges::input_range<GridRange>);
@@ -3,8 +3,13 @@
 
 PointMap ReadPointMap(std::istream& input, char emptyChar)
 {
-	PointMap p;
-	std::vector<std::string> lines = ReadAllLines(input);
+	return ReadPointMap(input, emptyChar, std::pmr::get_default_resource());
+}
+
+PointMap ReadPointMap(std::istream& input, char emptyChar, std::pmr::memory_resource* resource)
+{
+	PointMap p{ std::pmr::map<Point2, char>(resource) };
+	std::pmr::vector<std::pmr::string> lines = ReadAllLines(input, resource);
 	p.Size.X = lines[0].size();
 	p.Size.Y = lines.size();
 
@@ -29,11 +34,11 @@ void PrintPointMap(const PointMap& map, char emptyChar)
 	{
 		for (int64_t x = 0; x < map.Size.X; x++)
 		{
-			std::map<Point2, char>::const_iterator entry = map.Data.find({ x, y });
+			std::pmr::map<Point2, char>::const_iterator entry = map.Data.find({ x, y });
 			char c = (entry == map.Data.end()) ? emptyChar : entry->second;
-			printf("%c", c);
+			PuzzlePrintf("%c", c);
 		}
-		printf("\n");
+		PuzzlePrintf("\n");
 	}
 }
 
@@ -50,7 +55,7 @@ bool IsOutside(const Point2& p, const PointMap& map)
 PointMap RotateClockwise(const PointMap& map)
 {
 	PointMap newMap;
-	for (std::map<Point2, char>::const_reference point : map.Data)
+	for (std::pmr::map<Point2, char>::const_reference point : map.Data)
 	{
 		newMap.Data[Point2{ -point.first.Y, point.first.X }] = point.second;
 	}
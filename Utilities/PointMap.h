@@ -2,15 +2,17 @@
 
 #include "Point2.h"
 #include <map>
+#include <memory_resource>
 #include <istream>
 
 struct PointMap
 {
-	std::map<Point2, char> Data;
+	std::pmr::map<Point2, char> Data;
 	Point2 Size{ 0, 0 };
 };
 
 PointMap ReadPointMap(std::istream& input, char emptyChar = '.');
+PointMap ReadPointMap(std::istream& input, char emptyChar, std::pmr::memory_resource* resource);
 void PrintPointMap(const PointMap& map, char emptyChar = '.');
 bool IsInside(const Point2& p, const PointMap& map);
 bool IsOutside(const Point2& p, const PointMap& map);
@@ -0,0 +1,191 @@
+#include "stdafx.h"
+#include "Profile.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILE_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILE_HAS_RDTSC 1
+#else
+#define PROFILE_HAS_RDTSC 0
+#endif
+
+namespace
+{
+	struct ProfileEvent
+	{
+		const char* Name;
+		uint64_t StartTicks;
+		uint64_t EndTicks;
+		int64_t Allocations;
+		int64_t Bytes;
+	};
+
+	constexpr uint64_t RingCapacity = 1 << 16;
+
+	struct ProfileRing
+	{
+		std::unique_ptr<ProfileEvent[]> Events = std::make_unique<ProfileEvent[]>(RingCapacity);
+
+		// Only the owning thread stores to this; the release store publishes the event it wrote
+		std::atomic<uint64_t> WriteCount = 0;
+
+		// Events before this were dropped by ResetProfile
+		uint64_t ReadStart = 0;
+
+		// Index into ProfileState::Rings, exported as the trace tid
+		int64_t ThreadIndex = 0;
+
+		// Owned by a running thread; guarded by ProfileState::Mutex
+		bool InUse = false;
+	};
+
+	struct ProfileState
+	{
+		std::mutex Mutex;
+		std::vector<std::unique_ptr<ProfileRing>> Rings;
+		std::set<std::string> InternedNames;
+
+		// Pairs a tick count with wall time so ticks can be converted to microseconds on export
+		uint64_t BaseTicks = ReadProfileTicks();
+		std::chrono::steady_clock::time_point BaseTime = std::chrono::steady_clock::now();
+	};
+
+	ProfileState& GetProfileState()
+	{
+		static ProfileState state;
+		return state;
+	}
+
+	// Hands the thread's ring back when the thread exits. ParallelFor starts fresh threads on every
+	// call, so reusing rings keeps their number, and the tids in the trace, to the most threads
+	// that were ever recording at once. Events already in a ring are kept for the next owner.
+	struct ProfileRingOwner
+	{
+		ProfileRing* Ring = nullptr;
+
+		~ProfileRingOwner()
+		{
+			if (Ring != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(GetProfileState().Mutex);
+				Ring->InUse = false;
+			}
+		}
+	};
+
+	ProfileRing& GetThreadRing()
+	{
+		thread_local ProfileRingOwner owner;
+		if (owner.Ring == nullptr)
+		{
+			ProfileState& state = GetProfileState();
+			std::lock_guard<std::mutex> lock(state.Mutex);
+			auto freeRing = std::ranges::find_if(state.Rings, [](const std::unique_ptr<ProfileRing>& ring) { return !ring->InUse; });
+			if (freeRing == state.Rings.end())
+			{
+				state.Rings.push_back(std::make_unique<ProfileRing>());
+				state.Rings.back()->ThreadIndex = (int64_t)state.Rings.size() - 1;
+				freeRing = state.Rings.end() - 1;
+			}
+			owner.Ring = freeRing->get();
+			owner.Ring->InUse = true;
+		}
+		return *owner.Ring;
+	}
+
+	void WriteJsonString(FILE* f, const char* s)
+	{
+		fputc('"', f);
+		for (; *s != '\0'; s++)
+		{
+			if ((*s == '"') || (*s == '\\'))
+			{
+				fputc('\\', f);
+			}
+			fputc(*s, f);
+		}
+		fputc('"', f);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t ReadProfileTicks()
+{
+#if PROFILE_HAS_RDTSC
+	return __rdtsc();
+#else
+	return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+void RecordProfileZone(const char* name, uint64_t startTicks, uint64_t endTicks, int64_t allocations, int64_t bytes)
+{
+	ProfileRing& ring = GetThreadRing();
+	uint64_t writeCount = ring.WriteCount.load(std::memory_order_relaxed);
+	ring.Events[writeCount % RingCapacity] = { name, startTicks, endTicks, allocations, bytes };
+	ring.WriteCount.store(writeCount + 1, std::memory_order_release);
+}
+
+const char* InternProfileName(const std::string& name)
+{
+	ProfileState& state = GetProfileState();
+	std::lock_guard<std::mutex> lock(state.Mutex);
+	return state.InternedNames.insert(name).first->c_str();
+}
+
+bool ExportProfileTrace(const std::string& filename)
+{
+	ProfileState& state = GetProfileState();
+	std::lock_guard<std::mutex> lock(state.Mutex);
+
+	FILE* f = fopen(filename.c_str(), "w");
+	if (f == nullptr)
+		return false;
+
+	uint64_t endTicks = ReadProfileTicks();
+	double elapsedMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - state.BaseTime).count();
+	double microsecondsPerTick = (endTicks > state.BaseTicks) ? elapsedMicroseconds / (double)(endTicks - state.BaseTicks) : 0.0;
+
+	fprintf(f, "{\"traceEvents\":[\n");
+	bool first = true;
+	for (const std::unique_ptr<ProfileRing>& ring : state.Rings)
+	{
+		uint64_t writeCount = ring->WriteCount.load(std::memory_order_acquire);
+		uint64_t readStart = std::max(ring->ReadStart, (writeCount > RingCapacity) ? writeCount - RingCapacity : 0);
+		for (uint64_t i = readStart; i < writeCount; i++)
+		{
+			const ProfileEvent& event = ring->Events[i % RingCapacity];
+			double start = (double)(int64_t)(event.StartTicks - state.BaseTicks) * microsecondsPerTick;
+			double duration = (double)(event.EndTicks - event.StartTicks) * microsecondsPerTick;
+
+			fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+			WriteJsonString(f, event.Name);
+			fprintf(f, ",\"ph\":\"X\",\"pid\":0,\"tid\":%" PRId64 ",\"ts\":%.3f,\"dur\":%.3f", ring->ThreadIndex, start, duration);
+#if ALLOCATION_TRACKING_ENABLED
+			fprintf(f, ",\"args\":{\"allocations\":%" PRId64 ",\"bytes\":%" PRId64 "}", event.Allocations, event.Bytes);
+#endif
+			fputc('}', f);
+			first = false;
+		}
+	}
+	fprintf(f, "\n]}\n");
+	fclose(f);
+	return true;
+}
+
+void ResetProfile()
+{
+	ProfileState& state = GetProfileState();
+	std::lock_guard<std::mutex> lock(state.Mutex);
+	for (const std::unique_ptr<ProfileRing>& ring : state.Rings)
+	{
+		ring->ReadStart = ring->WriteCount.load(std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "AllocationTracking.h"
+
+#include <string>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Zones are on in Debug builds. Define AOC_PROFILE to keep them in Release; otherwise
+// PROFILE_SCOPE expands to nothing and costs nothing.
+#if !defined(PROFILING_ENABLED)
+#if defined(_DEBUG) || defined(AOC_PROFILE)
+#define PROFILING_ENABLED 1
+#else
+#define PROFILING_ENABLED 0
+#endif
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+// Raw timestamp; rdtsc where available, otherwise steady_clock ticks
+uint64_t ReadProfileTicks();
+
+// Appends a finished zone to the calling thread's ring buffer. Only the owning thread writes
+// to a buffer, so this never locks. The oldest zones are overwritten once a buffer is full.
+// The name must outlive the trace; string literals or InternProfileName both do. The allocation
+// counts are those made on this thread inside the zone, and only exported when tracking is on.
+void RecordProfileZone(const char* name, uint64_t startTicks, uint64_t endTicks, int64_t allocations = 0, int64_t bytes = 0);
+
+// Keeps a copy of a name made at runtime so it can label zones
+const char* InternProfileName(const std::string& name);
+
+// Writes every recorded zone as Chrome trace event JSON, which chrome://tracing and
+// ui.perfetto.dev both load. Call once the threads being profiled have finished.
+bool ExportProfileTrace(const std::string& filename);
+
+// Drops every recorded zone
+void ResetProfile();
+
+//////////////////////////////////////////////////////////////////////////
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name)
+		: m_name(name)
+	{
+#if ALLOCATION_TRACKING_ENABLED
+		ReadThreadAllocationTotals(&m_startAllocations, &m_startBytes);
+#endif
+		m_startTicks = ReadProfileTicks();
+	}
+
+	~ProfileScope()
+	{
+		uint64_t endTicks = ReadProfileTicks();
+#if ALLOCATION_TRACKING_ENABLED
+		int64_t allocations = 0;
+		int64_t bytes = 0;
+		ReadThreadAllocationTotals(&allocations, &bytes);
+		RecordProfileZone(m_name, m_startTicks, endTicks, allocations - m_startAllocations, bytes - m_startBytes);
+#else
+		RecordProfileZone(m_name, m_startTicks, endTicks);
+#endif
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* m_name;
+	uint64_t m_startTicks = 0;
+#if ALLOCATION_TRACKING_ENABLED
+	int64_t m_startAllocations = 0;
+	int64_t m_startBytes = 0;
+#endif
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILING_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "PuzzleArena.h"
+
+namespace
+{
+	thread_local std::pmr::memory_resource* CurrentArena = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+PuzzleArena::PuzzleArena(size_t initialSize)
+	: m_resource(initialSize, std::pmr::new_delete_resource())
+{
+}
+
+int64_t PuzzleArena::GetBytesAllocated() const
+{
+	return m_bytesAllocated;
+}
+
+void* PuzzleArena::do_allocate(size_t bytes, size_t alignment)
+{
+	while (m_lock.test_and_set(std::memory_order_acquire))
+	{
+		m_lock.wait(true, std::memory_order_relaxed);
+	}
+
+	void* p = nullptr;
+	try
+	{
+		p = m_resource.allocate(bytes, alignment);
+		m_bytesAllocated += (int64_t)bytes;
+	}
+	catch (...)
+	{
+		m_lock.clear(std::memory_order_release);
+		m_lock.notify_one();
+		throw;
+	}
+
+	m_lock.clear(std::memory_order_release);
+	m_lock.notify_one();
+	return p;
+}
+
+void PuzzleArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	(void)p;
+	(void)bytes;
+	(void)alignment;
+}
+
+bool PuzzleArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+std::pmr::memory_resource* GetPuzzleArena()
+{
+	return (CurrentArena != nullptr) ? CurrentArena : std::pmr::get_default_resource();
+}
+
+void SetPuzzleArena(std::pmr::memory_resource* arena)
+{
+	CurrentArena = arena;
+}
+
+PuzzleArenaScope::PuzzleArenaScope(std::pmr::memory_resource* arena)
+	: m_previous(CurrentArena)
+{
+	CurrentArena = arena;
+}
+
+PuzzleArenaScope::~PuzzleArenaScope()
+{
+	CurrentArena = m_previous;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <memory_resource>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Monotonic arena for one puzzle part. Allocating is a pointer bump behind a spinlock, so
+// ParallelFor workers can share it; deallocating does nothing and the whole lot goes back to
+// the heap when the arena is destroyed.
+class PuzzleArena : public std::pmr::memory_resource
+{
+public:
+	explicit PuzzleArena(size_t initialSize = 64 * 1024);
+
+	PuzzleArena(const PuzzleArena&) = delete;
+	PuzzleArena& operator=(const PuzzleArena&) = delete;
+
+	int64_t GetBytesAllocated() const;
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	std::pmr::monotonic_buffer_resource m_resource;
+	std::atomic_flag m_lock;
+	int64_t m_bytesAllocated = 0;
+};
+
+// The arena of the part running on this thread, or the default resource outside of one. Pass
+// it to the pmr overloads in Utilities, e.g. ReadAllLines(input, GetPuzzleArena()). Nothing
+// allocated from it may outlive the part.
+std::pmr::memory_resource* GetPuzzleArena();
+
+// For passing the current arena on to worker threads; nullptr goes back to the default resource
+void SetPuzzleArena(std::pmr::memory_resource* arena);
+
+// Makes an arena current on this thread until the scope ends. A null arena suspends the
+// current one, for work whose results must outlive the part.
+class PuzzleArenaScope
+{
+public:
+	explicit PuzzleArenaScope(std::pmr::memory_resource* arena);
+	~PuzzleArenaScope();
+
+	PuzzleArenaScope(const PuzzleArenaScope&) = delete;
+	PuzzleArenaScope& operator=(const PuzzleArenaScope&) = delete;
+
+private:
+	std::pmr::memory_resource* m_previous;
+};
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,446 @@
+#include "stdafx.h"
+#include "PuzzleCommandLine.h"
+#include "PuzzleRunner.h"
+#include "Profile.h"
+
+namespace
+{
+	bool GlobMatch(const char* pattern, const char* text)
+	{
+		for (; *pattern != '\0'; pattern++, text++)
+		{
+			if (*pattern == '*')
+			{
+				for (const char* rest = text; ; rest++)
+				{
+					if (GlobMatch(pattern + 1, rest))
+						return true;
+					if (*rest == '\0')
+						return false;
+				}
+			}
+
+			if ((*text == '\0') || ((*pattern != '?') && (*pattern != *text)))
+				return false;
+		}
+		return *text == '\0';
+	}
+
+	// Plain numbers compare by value so "5" and "05" both pick out day 5. An empty field, as in
+	// "2023/" or "2023//B", matches anything.
+	bool FieldMatches(const std::string& pattern, const std::string& paddedValue)
+	{
+		if (pattern.empty())
+			return true;
+
+		if (std::all_of(pattern.begin(), pattern.end(), [](char c) { return isdigit((unsigned char)c) != 0; }))
+			return atoll(pattern.c_str()) == atoll(paddedValue.c_str());
+
+		return GlobMatch(pattern.c_str(), paddedValue.c_str());
+	}
+
+	enum class ReportFormat
+	{
+		Text,
+		Json,
+		Csv,
+	};
+
+	struct CommandLineOptions
+	{
+		std::vector<std::string> Selectors;
+		PuzzleRunOptions Run;
+		PuzzleBenchmarkOptions Benchmark;
+		bool IsBenchmark = false;
+		ReportFormat Format = ReportFormat::Text;
+		std::string OutputFilename;
+		std::string TraceFilename;
+	};
+
+	void PrintUsage(FILE* f)
+	{
+		fprintf(f,
+			"Usage: AdventOfCodeWhippet [options] [year[/day[/part]]...]\n"
+			"  --threads N       worker threads for a normal run, 0 for one per core\n"
+			"  --input-dir DIR   directory holding the AoCYYYY folders\n"
+			"  --timings FILE    schedule the slowest parts first from FILE, and update it\n"
+			"  --repeat N        benchmark each selected part N times\n"
+			"  --warmup N        untimed runs before each benchmark\n"
+			"  --counters        benchmark with hardware counters as well as timings (Linux only)\n"
+			"  --format F        benchmark report as text, json or csv\n"
+			"  --output FILE     write the benchmark report to FILE\n"
+			"  --verify FILE     check answers against FILE, stopping at the first mismatch (not when benchmarking)\n"
+			"  --record FILE     save this run's answers to FILE for later --verify runs (not when benchmarking)\n"
+			"  --trace FILE      write profile zones as Chrome trace JSON to FILE\n");
+	}
+
+	bool ParseInteger(const char* text, int64_t minimum, int64_t* value)
+	{
+		char* end = nullptr;
+		long long parsed = strtoll(text, &end, 10);
+		if ((end == text) || (*end != '\0') || (parsed < minimum))
+			return false;
+
+		*value = parsed;
+		return true;
+	}
+
+	bool ParseCommandLine(int argc, const char* const* argv, CommandLineOptions* options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
+			if ((arg == "--help") || (arg == "-h"))
+				return false;
+
+			if (arg.rfind("--", 0) != 0)
+			{
+				options->Selectors.push_back(arg);
+				continue;
+			}
+
+			if (arg == "--counters")
+			{
+				options->Benchmark.CollectCounters = true;
+				options->IsBenchmark = true;
+				continue;
+			}
+
+			static const std::set<std::string> valueOptions = { "--threads", "--input-dir", "--timings", "--repeat", "--warmup", "--format", "--output", "--verify", "--record", "--trace" };
+			if (valueOptions.count(arg) == 0)
+			{
+				fprintf(stderr, "Unknown option %s\n", arg.c_str());
+				return false;
+			}
+
+			if (i + 1 >= argc)
+			{
+				fprintf(stderr, "Missing value for %s\n", arg.c_str());
+				return false;
+			}
+
+			const char* value = argv[++i];
+			bool valid = true;
+			if (arg == "--threads")
+			{
+				valid = ParseInteger(value, 0, &options->Run.ThreadCount);
+			}
+			else if (arg == "--input-dir")
+			{
+				options->Run.InputDirectory = value;
+				options->Benchmark.InputDirectory = value;
+			}
+			else if (arg == "--timings")
+			{
+				options->Run.TimingsFilename = value;
+			}
+			else if (arg == "--repeat")
+			{
+				valid = ParseInteger(value, 1, &options->Benchmark.RepeatCount);
+				options->IsBenchmark = true;
+			}
+			else if (arg == "--warmup")
+			{
+				valid = ParseInteger(value, 0, &options->Benchmark.WarmupCount);
+			}
+			else if (arg == "--format")
+			{
+				std::string format = value;
+				if (format == "text")
+					options->Format = ReportFormat::Text;
+				else if (format == "json")
+					options->Format = ReportFormat::Json;
+				else if (format == "csv")
+					options->Format = ReportFormat::Csv;
+				else
+					valid = false;
+			}
+			else if (arg == "--output")
+			{
+				options->OutputFilename = value;
+			}
+			else if (arg == "--verify")
+			{
+				options->Run.ExpectedAnswersFilename = value;
+			}
+			else if (arg == "--record")
+			{
+				options->Run.RecordAnswersFilename = value;
+			}
+			else if (arg == "--trace")
+			{
+				options->TraceFilename = value;
+			}
+
+			if (!valid)
+			{
+				fprintf(stderr, "Bad value '%s' for %s\n", value, arg.c_str());
+				return false;
+			}
+		}
+
+		// Benchmark runs don't check or record answers, so refuse these rather than ignore them
+		if (options->IsBenchmark && (!options->Run.ExpectedAnswersFilename.empty() || !options->Run.RecordAnswersFilename.empty()))
+		{
+			fprintf(stderr, "--verify and --record can't be used when benchmarking\n");
+			return false;
+		}
+		return true;
+	}
+
+	void ExportTrace(const std::string& filename)
+	{
+#if PROFILING_ENABLED
+		if (filename.empty())
+			return;
+
+		if (!ExportProfileTrace(filename))
+		{
+			fprintf(stderr, "Couldn't write %s\n", filename.c_str());
+		}
+#else
+		(void)filename;
+#endif
+	}
+
+	// Counter columns, in PerfCounterValues order
+	constexpr const char* CounterNames[] = { "cycles", "instructions", "cache_misses", "branch_misses", "page_faults" };
+
+	void GetCounters(const PerfCounterValues& values, int64_t counters[5])
+	{
+		counters[0] = values.Cycles;
+		counters[1] = values.Instructions;
+		counters[2] = values.CacheMisses;
+		counters[3] = values.BranchMisses;
+		counters[4] = values.PageFaults;
+	}
+
+	void WriteReport(FILE* f, ReportFormat format, bool withCounters, bool withAllocations, const std::vector<PuzzleBenchmarkResult>& results)
+	{
+		if (format == ReportFormat::Json)
+		{
+			fprintf(f, "[\n");
+			for (size_t i = 0; i < results.size(); i++)
+			{
+				const PuzzleBenchmarkResult& result = results[i];
+				fprintf(f, "  { \"year\": %" PRId64 ", \"day\": %" PRId64 ", \"part\": \"%c\", \"runs\": %" PRId64
+					", \"min_ms\": %.4f, \"median_ms\": %.4f, \"p95_ms\": %.4f, \"input_bytes\": %" PRId64 ", \"bytes_per_second\": %.1f",
+					result.Puzzle->Year, result.Puzzle->Day, result.Puzzle->Part, result.RunCount,
+					result.MinMilliseconds, result.MedianMilliseconds, result.P95Milliseconds,
+					result.InputBytes, result.BytesPerSecond);
+				fprintf(f, ", \"input_missing\": %s", result.InputMissing ? "true" : "false");
+				if (withCounters)
+				{
+					int64_t counters[5];
+					GetCounters(result.Counters, counters);
+					for (int c = 0; c < 5; c++)
+					{
+						if (counters[c] < 0)
+							fprintf(f, ", \"%s\": null", CounterNames[c]);
+						else
+							fprintf(f, ", \"%s\": %" PRId64, CounterNames[c], counters[c]);
+					}
+				}
+				if (withAllocations)
+				{
+					fprintf(f, ", \"allocations\": %" PRId64 ", \"allocated_bytes\": %" PRId64 ", \"peak_live_bytes\": %" PRId64,
+						result.Allocations.Allocations, result.Allocations.Bytes, result.Allocations.PeakLiveBytes);
+				}
+				fprintf(f, " }%s\n", (i + 1 < results.size()) ? "," : "");
+			}
+			fprintf(f, "]\n");
+		}
+		else if (format == ReportFormat::Csv)
+		{
+			fprintf(f, "year,day,part,runs,min_ms,median_ms,p95_ms,input_bytes,bytes_per_second,input_missing");
+			if (withCounters)
+			{
+				for (const char* name : CounterNames)
+				{
+					fprintf(f, ",%s", name);
+				}
+			}
+			if (withAllocations)
+			{
+				fprintf(f, ",allocations,allocated_bytes,peak_live_bytes");
+			}
+			fprintf(f, "\n");
+
+			for (const PuzzleBenchmarkResult& result : results)
+			{
+				fprintf(f, "%" PRId64 ",%" PRId64 ",%c,%" PRId64 ",%.4f,%.4f,%.4f,%" PRId64 ",%.1f",
+					result.Puzzle->Year, result.Puzzle->Day, result.Puzzle->Part, result.RunCount,
+					result.MinMilliseconds, result.MedianMilliseconds, result.P95Milliseconds,
+					result.InputBytes, result.BytesPerSecond);
+				fprintf(f, ",%d", result.InputMissing ? 1 : 0);
+				if (withCounters)
+				{
+					int64_t counters[5];
+					GetCounters(result.Counters, counters);
+					for (int64_t count : counters)
+					{
+						if (count < 0)
+							fprintf(f, ",");
+						else
+							fprintf(f, ",%" PRId64, count);
+					}
+				}
+				if (withAllocations)
+				{
+					fprintf(f, ",%" PRId64 ",%" PRId64 ",%" PRId64, result.Allocations.Allocations, result.Allocations.Bytes, result.Allocations.PeakLiveBytes);
+				}
+				fprintf(f, "\n");
+			}
+		}
+		else
+		{
+			fprintf(f, "%-14s %6s %12s %12s %12s %14s", "Puzzle", "Runs", "Min ms", "Median ms", "P95 ms", "MB/s");
+			if (withCounters)
+			{
+				fprintf(f, " %14s %14s %6s %12s %12s %10s", "Cycles", "Instructions", "IPC", "Cache miss", "Branch miss", "Faults");
+			}
+			if (withAllocations)
+			{
+				fprintf(f, " %12s %14s %14s", "Allocs", "Alloc bytes", "Peak live");
+			}
+			fprintf(f, "\n");
+
+			for (const PuzzleBenchmarkResult& result : results)
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "%" PRId64 "/%02" PRId64 "/%c", result.Puzzle->Year, result.Puzzle->Day, result.Puzzle->Part);
+				if (result.InputMissing)
+				{
+					fprintf(f, "%-14s %6s missing input\n", name, "-");
+					continue;
+				}
+				fprintf(f, "%-14s %6" PRId64 " %12.4f %12.4f %12.4f %14.2f",
+					name, result.RunCount, result.MinMilliseconds, result.MedianMilliseconds, result.P95Milliseconds,
+					result.BytesPerSecond / (1024.0 * 1024.0));
+				if (withCounters)
+				{
+					const PerfCounterValues& counters = result.Counters;
+					auto printCount = [f](int64_t count, int width)
+						{
+							if (count < 0)
+								fprintf(f, " %*s", width, "n/a");
+							else
+								fprintf(f, " %*" PRId64, width, count);
+						};
+					printCount(counters.Cycles, 14);
+					printCount(counters.Instructions, 14);
+					if ((counters.Cycles > 0) && (counters.Instructions >= 0))
+						fprintf(f, " %6.2f", (double)counters.Instructions / (double)counters.Cycles);
+					else
+						fprintf(f, " %6s", "n/a");
+					printCount(counters.CacheMisses, 12);
+					printCount(counters.BranchMisses, 12);
+					printCount(counters.PageFaults, 10);
+				}
+				if (withAllocations)
+				{
+					fprintf(f, " %12" PRId64 " %14" PRId64 " %14" PRId64, result.Allocations.Allocations, result.Allocations.Bytes, result.Allocations.PeakLiveBytes);
+				}
+				fprintf(f, "\n");
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool PuzzleMatchesSelector(const PuzzleEntry& puzzle, const std::string& selector)
+{
+	char year[24];
+	char day[24];
+	snprintf(year, sizeof(year), "%04" PRId64, puzzle.Year);
+	snprintf(day, sizeof(day), "%02" PRId64, puzzle.Day);
+	const std::string values[] = { year, day, std::string(1, puzzle.Part) };
+
+	size_t start = 0;
+	for (const std::string& value : values)
+	{
+		if (start > selector.size())
+			return true;
+
+		size_t end = std::min(selector.find('/', start), selector.size());
+		if (!FieldMatches(selector.substr(start, end - start), value))
+			return false;
+
+		start = end + 1;
+	}
+	return start > selector.size();
+}
+
+int RunPuzzleCommandLine(int argc, const char* const* argv)
+{
+	CommandLineOptions options;
+	if (!ParseCommandLine(argc, argv, &options))
+	{
+		PrintUsage(stderr);
+		return 1;
+	}
+
+	std::vector<PuzzleEntry> selected;
+	for (const PuzzleEntry& puzzle : GetRegisteredPuzzles())
+	{
+		bool matches = options.Selectors.empty() || std::any_of(options.Selectors.begin(), options.Selectors.end(),
+			[&](const std::string& selector) { return PuzzleMatchesSelector(puzzle, selector); });
+		if (matches)
+		{
+			selected.push_back(puzzle);
+		}
+	}
+
+	if (selected.empty())
+	{
+		fprintf(stderr, "No puzzles match the selection\n");
+		return 1;
+	}
+
+#if !PROFILING_ENABLED
+	if (!options.TraceFilename.empty())
+	{
+		fprintf(stderr, "Profile zones are compiled out of this build; define AOC_PROFILE to trace\n");
+	}
+#endif
+
+	if (!options.IsBenchmark)
+	{
+		bool passed = RunPuzzles(selected, options.Run);
+		ExportTrace(options.TraceFilename);
+		return passed ? 0 : 1;
+	}
+
+	if (options.Benchmark.CollectCounters && !PerfCounters().IsAvailable())
+	{
+		fprintf(stderr, "No performance counters could be opened; they'll be reported as unavailable\n");
+	}
+
+	std::sort(selected.begin(), selected.end(), [](const PuzzleEntry& a, const PuzzleEntry& b)
+		{
+			return std::tie(a.Year, a.Day, a.Part) < std::tie(b.Year, b.Day, b.Part);
+		});
+	std::vector<PuzzleBenchmarkResult> results = BenchmarkPuzzles(selected, options.Benchmark);
+
+	FILE* f = stdout;
+	if (!options.OutputFilename.empty())
+	{
+		f = fopen(options.OutputFilename.c_str(), "w");
+		if (f == nullptr)
+		{
+			fprintf(stderr, "Couldn't open %s\n", options.OutputFilename.c_str());
+			return 1;
+		}
+	}
+
+	WriteReport(f, options.Format, options.Benchmark.CollectCounters, ALLOCATION_TRACKING_ENABLED != 0, results);
+	ExportTrace(options.TraceFilename);
+
+	if (f != stdout)
+	{
+		fclose(f);
+	}
+	bool anyMissing = std::ranges::any_of(results, [](const PuzzleBenchmarkResult& result) { return result.InputMissing; });
+	return anyMissing ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+struct PuzzleEntry;
+
+//////////////////////////////////////////////////////////////////////////
+
+// Selectors look like year[/day[/part]], each field either a number or a glob using * and ?.
+// Missing or empty fields match everything, so "2023" and "2023/" are the whole year and "*/1?/B"
+// is part B of days 10-19.
+bool PuzzleMatchesSelector(const PuzzleEntry& puzzle, const std::string& selector);
+
+// Entry point for the executable:
+//   AdventOfCodeWhippet [options] [selector...]
+//     --threads N       worker threads for a normal run, 0 for one per core
+//     --input-dir DIR   directory holding the AoCYYYY folders
+//     --timings FILE    wall times from earlier runs, to start the slowest parts first; updated after the run
+//     --repeat N        benchmark each selected part N times instead of solving once in parallel
+//     --warmup N        untimed runs before each benchmark
+//     --counters        benchmark with perf_event_open counters alongside the timings
+//     --format F        benchmark report as text, json or csv
+//     --output FILE     write the benchmark report to FILE rather than stdout
+//     --verify FILE     check each answer against FILE; any mismatch stops unstarted puzzles
+//     --record FILE     save this run's answers to FILE, in the format --verify reads
+//                       (neither --verify nor --record can be combined with benchmarking)
+//     --trace FILE      write PROFILE_SCOPE zones to FILE as Chrome trace JSON
+// Returns the process exit code, non-zero if verification failed or a benchmarked part had no input.
+int RunPuzzleCommandLine(int argc, const char* const* argv);
+
+//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,113 @@
+#include "stdafx.h"
+#include "PuzzleInput.h"
+#include "Parallel.h"
+
+#include <mutex>
+
+namespace
+{
+	struct PuzzleInputCache
+	{
+		std::mutex Mutex;
+		std::unordered_map<std::string, std::shared_ptr<const PuzzleInputData>> Files;
+	};
+
+	PuzzleInputCache& GetCache()
+	{
+		static PuzzleInputCache cache;
+		return cache;
+	}
+
+	std::shared_ptr<const PuzzleInputData> LoadPuzzleInput(const std::string& filename)
+	{
+		PROFILE_SCOPE("LoadPuzzleInput");
+		auto data = std::make_shared<PuzzleInputData>();
+
+		std::ifstream input(filename, std::ios::binary);
+		if (input)
+		{
+			data->Found = true;
+			input.seekg(0, std::ios::end);
+			std::streamoff size = input.tellg();
+			input.seekg(0, std::ios::beg);
+			if (size > 0)
+			{
+				data->Text.resize((size_t)size);
+				input.read(data->Text.data(), size);
+				data->Text.resize((size_t)input.gcount());
+			}
+			std::erase(data->Text, '\r');
+		}
+
+		data->Lines.assign(data->Text.begin(), data->Text.end());
+		std::ranges::replace(data->Lines, '\n', '\0');
+		if (!data->Lines.empty() && (data->Lines.back() != '\0'))
+		{
+			data->Lines.push_back('\0');
+		}
+		return data;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool PreloadPuzzleInputs(const std::vector<std::string>& filenames)
+{
+	std::set<std::string> unique(filenames.begin(), filenames.end());
+	std::vector<std::string> missing;
+	{
+		PuzzleInputCache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.Mutex);
+		std::ranges::copy_if(unique, std::back_inserter(missing), [&](const std::string& filename) { return !cache.Files.contains(filename); });
+	}
+
+	std::vector<std::shared_ptr<const PuzzleInputData>> loaded(missing.size());
+	ParallelFor((int64_t)missing.size(), [&](int64_t i, int64_t)
+		{
+			loaded[i] = LoadPuzzleInput(missing[i]);
+		});
+
+	bool allFound = true;
+	PuzzleInputCache& cache = GetCache();
+	std::lock_guard<std::mutex> lock(cache.Mutex);
+	for (size_t i = 0; i < missing.size(); i++)
+	{
+		cache.Files.emplace(missing[i], std::move(loaded[i]));
+	}
+	for (const std::string& filename : unique)
+	{
+		if (!cache.Files.at(filename)->Found)
+		{
+			allFound = false;
+		}
+	}
+	return allFound;
+}
+
+std::shared_ptr<const PuzzleInputData> GetPuzzleInputData(const std::string& filename)
+{
+	PuzzleInputCache& cache = GetCache();
+	{
+		std::lock_guard<std::mutex> lock(cache.Mutex);
+		auto file = cache.Files.find(filename);
+		if (file != cache.Files.end())
+			return file->second;
+	}
+
+	// Load outside the lock; if another thread raced us here, keep whichever landed first
+	std::shared_ptr<const PuzzleInputData> data = LoadPuzzleInput(filename);
+	std::lock_guard<std::mutex> lock(cache.Mutex);
+	return cache.Files.emplace(filename, std::move(data)).first->second;
+}
+
+std::string_view GetPuzzleInput(const std::string& filename)
+{
+	return GetPuzzleInputData(filename)->Text;
+}
+
+void ClearPuzzleInputCache()
+{
+	PuzzleInputCache& cache = GetCache();
+	std::lock_guard<std::mutex> lock(cache.Mutex);
+	cache.Files.clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+
+// One input file as loaded into the cache. Never modified once loaded, so any number of
+// puzzle parts can read it at once.
+struct PuzzleInputData
+{
+	// The whole file, with any '\r' line endings stripped
+	std::string Text;
+
+	// Text with every '\n' replaced by '\0' and '\0' terminated, the layout ILineSource walks.
+	// Empty when the file is.
+	std::vector<char> Lines;
+
+	// False when the file couldn't be opened, leaving Text and Lines empty
+	bool Found = false;
+};
+
+// Loads every file on the ParallelFor pool. Files already cached aren't read again. Returns
+// false if any couldn't be opened; reporting them is left to the caller.
+bool PreloadPuzzleInputs(const std::vector<std::string>& filenames);
+
+// Returns the cached file, reading it first if it isn't cached yet. A missing file is cached
+// as empty with Found unset, just as an ifstream on it would read nothing.
+std::shared_ptr<const PuzzleInputData> GetPuzzleInputData(const std::string& filename);
+
+// The cached text of a file. The view stays valid until ClearPuzzleInputCache.
+std::string_view GetPuzzleInput(const std::string& filename);
+
+void ClearPuzzleInputCache();
+
+//////////////////////////////////////////////////////////////////////////
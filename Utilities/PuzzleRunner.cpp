@@ -0,0 +1,531 @@
+#include "stdafx.h"
+#include "PuzzleRunner.h"
+#include "Parallel.h"
+#include "Profile.h"
+#include "PuzzleInput.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <filesystem>
+#include <mutex>
+
+namespace
+{
+	thread_local std::string* CurrentPuzzleOutput = nullptr;
+
+	std::atomic<uint64_t> PuzzleRunGeneration = 1;
+
+	struct PuzzleModelCaches
+	{
+		std::mutex Mutex;
+		std::vector<IPuzzleModelCache*> Caches;
+	};
+
+	PuzzleModelCaches& GetModelCaches()
+	{
+		static PuzzleModelCaches caches;
+		return caches;
+	}
+
+	std::vector<PuzzleEntry>& GetRegistry()
+	{
+		static std::vector<PuzzleEntry> registry;
+		return registry;
+	}
+
+	using PuzzleKey = std::tuple<int64_t, int64_t, char>;
+
+	PuzzleKey GetPuzzleKey(const PuzzleEntry& puzzle)
+	{
+		return { puzzle.Year, puzzle.Day, puzzle.Part };
+	}
+
+	std::map<PuzzleKey, double> LoadTimings(const std::string& filename)
+	{
+		std::map<PuzzleKey, double> timings;
+		if (filename.empty())
+			return timings;
+
+		std::ifstream input(filename);
+		int64_t year = 0;
+		int64_t day = 0;
+		char part = 'A';
+		double milliseconds = 0.0;
+		while (input >> year >> day >> part >> milliseconds)
+		{
+			timings[{ year, day, part }] = milliseconds;
+		}
+		return timings;
+	}
+
+	void SaveTimings(const std::string& filename, const std::map<PuzzleKey, double>& timings)
+	{
+		if (filename.empty())
+			return;
+
+		FILE* f = fopen(filename.c_str(), "w");
+		if (f == nullptr)
+			return;
+
+		for (const auto& [key, milliseconds] : timings)
+		{
+			fprintf(f, "%" PRId64 " %02" PRId64 " %c %.3f\n", std::get<0>(key), std::get<1>(key), std::get<2>(key), milliseconds);
+		}
+		fclose(f);
+	}
+
+	std::map<PuzzleKey, std::string> LoadAnswers(const std::string& filename)
+	{
+		std::map<PuzzleKey, std::string> answers;
+		std::ifstream input(filename);
+		if (!input)
+		{
+			fprintf(stderr, "Couldn't open %s\n", filename.c_str());
+			return answers;
+		}
+
+		int64_t year = 0;
+		int64_t day = 0;
+		char part = 'A';
+		std::string answer;
+		while (input >> year >> day >> part >> std::ws && std::getline(input, answer))
+		{
+			answers[{ year, day, part }] = answer;
+		}
+		return answers;
+	}
+
+	void SaveAnswers(const std::string& filename, const std::map<PuzzleKey, std::string>& answers)
+	{
+		FILE* f = fopen(filename.c_str(), "w");
+		if (f == nullptr)
+		{
+			fprintf(stderr, "Couldn't write %s\n", filename.c_str());
+			return;
+		}
+
+		for (const auto& [key, answer] : answers)
+		{
+			fprintf(f, "%" PRId64 " %02" PRId64 " %c %s\n", std::get<0>(key), std::get<1>(key), std::get<2>(key), answer.c_str());
+		}
+		fclose(f);
+	}
+
+	std::string FormatAnswerLine(const PuzzleEntry& puzzle, const std::string& answer)
+	{
+		char prefix[64];
+		snprintf(prefix, sizeof(prefix), "[%" PRId64 "] Puzzle%02" PRId64 "_%c: ", puzzle.Year, puzzle.Day, puzzle.Part);
+		return prefix + answer + "\n";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void PuzzlePrintf(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	if (CurrentPuzzleOutput == nullptr)
+	{
+		vprintf(format, args);
+		va_end(args);
+		return;
+	}
+
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int length = vsnprintf(nullptr, 0, format, argsCopy);
+	va_end(argsCopy);
+
+	if (length > 0)
+	{
+		size_t oldSize = CurrentPuzzleOutput->size();
+		CurrentPuzzleOutput->resize(oldSize + (size_t)length + 1);
+		vsnprintf(CurrentPuzzleOutput->data() + oldSize, (size_t)length + 1, format, args);
+		CurrentPuzzleOutput->pop_back();
+	}
+	va_end(args);
+}
+
+bool RegisterPuzzle(int64_t year, int64_t day, char part, std::function<std::string(const std::string&)> solve, IPuzzleModelCache* modelCache)
+{
+	GetRegistry().push_back({ year, day, part, std::move(solve), modelCache });
+	return true;
+}
+
+const std::vector<PuzzleEntry>& GetRegisteredPuzzles()
+{
+	return GetRegistry();
+}
+
+std::string GetPuzzleInputFilename(const std::string& rootDirectory, const PuzzleEntry& puzzle)
+{
+	char filename[32];
+	snprintf(filename, sizeof(filename), "Puzzle%02" PRId64 ".txt", puzzle.Day);
+	return (std::filesystem::path(rootDirectory) / ("AoC" + std::to_string(puzzle.Year)) / filename).string();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+uint64_t GetPuzzleRunGeneration()
+{
+	return PuzzleRunGeneration.load(std::memory_order_acquire);
+}
+
+void BeginPuzzleRunGeneration()
+{
+	PuzzleRunGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void RegisterPuzzleModelCache(IPuzzleModelCache* cache)
+{
+	PuzzleModelCaches& caches = GetModelCaches();
+	std::lock_guard<std::mutex> lock(caches.Mutex);
+	caches.Caches.push_back(cache);
+}
+
+void ReleasePuzzleModels()
+{
+	PuzzleModelCaches& caches = GetModelCaches();
+	std::lock_guard<std::mutex> lock(caches.Mutex);
+	for (IPuzzleModelCache* cache : caches.Caches)
+	{
+		cache->Release();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+double SolvePuzzle(const PuzzleEntry& puzzle, const std::string& inputDirectory, std::string* output, std::string* answer, AllocationStats* allocations)
+{
+	std::string filename = GetPuzzleInputFilename(inputDirectory, puzzle);
+
+	std::string* previousOutput = CurrentPuzzleOutput;
+	CurrentPuzzleOutput = output;
+	auto start = std::chrono::steady_clock::now();
+	{
+		AllocationScope allocationScope;
+
+		// Everything the part allocates from GetPuzzleArena() goes back in one go at the end
+		PuzzleArena arena;
+		PuzzleArenaScope arenaScope(&arena);
+#if PROFILING_ENABLED
+		char zoneName[32];
+		snprintf(zoneName, sizeof(zoneName), "%" PRId64 "/%02" PRId64 "/%c", puzzle.Year, puzzle.Day, puzzle.Part);
+		ProfileScope zone(InternProfileName(zoneName));
+#endif
+		*answer = puzzle.Solve(filename);
+
+		if (allocations != nullptr)
+		{
+			*allocations = allocationScope.GetStats();
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	CurrentPuzzleOutput = previousOutput;
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+bool RunPuzzles(const std::vector<PuzzleEntry>& puzzles, const PuzzleRunOptions& options)
+{
+	// Output order is year, day then part, whatever order the puzzles were registered in
+	std::vector<const PuzzleEntry*> ordered;
+	for (const PuzzleEntry& puzzle : puzzles)
+	{
+		ordered.push_back(&puzzle);
+	}
+	std::stable_sort(ordered.begin(), ordered.end(), [](const PuzzleEntry* a, const PuzzleEntry* b)
+		{
+			return GetPuzzleKey(*a) < GetPuzzleKey(*b);
+		});
+
+	// Start the slowest puzzles first; ones with no recorded time are assumed to be slow
+	std::map<PuzzleKey, double> timings = LoadTimings(options.TimingsFilename);
+	std::vector<double> expected(ordered.size(), std::numeric_limits<double>::infinity());
+	for (size_t i = 0; i < ordered.size(); i++)
+	{
+		auto timing = timings.find(GetPuzzleKey(*ordered[i]));
+		if (timing != timings.end())
+		{
+			expected[i] = timing->second;
+		}
+	}
+
+	// Every input is read before any puzzle starts, so parts only ever see memory
+	std::vector<std::string> inputFilenames;
+	for (const PuzzleEntry* puzzle : ordered)
+	{
+		inputFilenames.push_back(GetPuzzleInputFilename(options.InputDirectory, *puzzle));
+	}
+	PreloadPuzzleInputs(inputFilenames);
+	BeginPuzzleRunGeneration();
+
+	std::vector<bool> inputMissing(ordered.size());
+	for (size_t i = 0; i < ordered.size(); i++)
+	{
+		inputMissing[i] = !GetPuzzleInputData(inputFilenames[i])->Found;
+	}
+
+	// Parts sharing a parsed model are one work item, run in order on one worker: the first one
+	// parses without holding up a second worker, and the model goes as soon as they're all done
+	std::vector<std::vector<size_t>> groups;
+	std::map<IPuzzleModelCache*, size_t> groupOfModelCache;
+	for (size_t i = 0; i < ordered.size(); i++)
+	{
+		IPuzzleModelCache* modelCache = ordered[i]->ModelCache;
+		if (modelCache == nullptr)
+		{
+			groups.push_back({ i });
+			continue;
+		}
+
+		auto [group, added] = groupOfModelCache.try_emplace(modelCache, groups.size());
+		if (added)
+		{
+			groups.emplace_back();
+		}
+		groups[group->second].push_back(i);
+	}
+
+	std::vector<double> groupExpected(groups.size(), 0.0);
+	for (size_t group = 0; group < groups.size(); group++)
+	{
+		for (size_t index : groups[group])
+		{
+			groupExpected[group] += expected[index];
+		}
+	}
+
+	std::vector<size_t> schedule(groups.size());
+	std::iota(schedule.begin(), schedule.end(), size_t{ 0 });
+	std::stable_sort(schedule.begin(), schedule.end(), [&](size_t a, size_t b) { return groupExpected[a] > groupExpected[b]; });
+
+	bool verifying = !options.ExpectedAnswersFilename.empty();
+	std::map<PuzzleKey, std::string> expectedAnswers;
+	if (verifying)
+	{
+		expectedAnswers = LoadAnswers(options.ExpectedAnswersFilename);
+	}
+
+	std::vector<std::string> outputs(ordered.size());
+	std::vector<std::string> answers(ordered.size());
+	std::vector<double> milliseconds(ordered.size(), 0.0);
+	std::vector<bool> solved(ordered.size(), false);
+	std::vector<bool> finished(ordered.size(), false);
+	size_t nextToPrint = 0;
+	std::mutex printMutex;
+	std::atomic<bool> failed = false;
+	int64_t matchedCount = 0;
+	int64_t mismatchedCount = 0;
+	int64_t uncheckedCount = 0;
+	int64_t missingCount = 0;
+
+	auto runPart = [&](size_t index)
+		{
+			const PuzzleEntry& puzzle = *ordered[index];
+
+			std::string output;
+			std::string answer;
+			double elapsed = 0.0;
+			bool skipped = failed || inputMissing[index];
+			if (inputMissing[index])
+			{
+				output = FormatAnswerLine(puzzle, "missing input " + inputFilenames[index]);
+			}
+			else if (!skipped)
+			{
+				elapsed = SolvePuzzle(puzzle, options.InputDirectory, &output, &answer);
+				output += FormatAnswerLine(puzzle, answer);
+			}
+			else
+			{
+				output = FormatAnswerLine(puzzle, "skipped after an earlier mismatch");
+			}
+
+			std::lock_guard<std::mutex> lock(printMutex);
+			if (inputMissing[index])
+			{
+				missingCount++;
+			}
+			else if (!skipped && verifying)
+			{
+				auto expectedAnswer = expectedAnswers.find(GetPuzzleKey(puzzle));
+				if (expectedAnswer == expectedAnswers.end())
+				{
+					uncheckedCount++;
+				}
+				else if (expectedAnswer->second == answer)
+				{
+					matchedCount++;
+				}
+				else
+				{
+					mismatchedCount++;
+					failed = true;
+					output += "  MISMATCH, expected " + expectedAnswer->second + "\n";
+				}
+			}
+
+			outputs[index] = std::move(output);
+			answers[index] = std::move(answer);
+			milliseconds[index] = elapsed;
+			solved[index] = !skipped;
+			finished[index] = true;
+			for (; (nextToPrint < ordered.size()) && finished[nextToPrint]; nextToPrint++)
+			{
+				fputs(outputs[nextToPrint].c_str(), stdout);
+				outputs[nextToPrint].clear();
+			}
+			fflush(stdout);
+		};
+
+	ParallelForWorkStealing((int64_t)schedule.size(), [&](int64_t scheduleIndex, int64_t)
+		{
+			const std::vector<size_t>& group = groups[schedule[scheduleIndex]];
+			for (size_t index : group)
+			{
+				runPart(index);
+			}
+
+			if (IPuzzleModelCache* modelCache = ordered[group.front()]->ModelCache)
+			{
+				modelCache->Release();
+			}
+		}, options.ThreadCount);
+
+	// Recording a subset of the puzzles keeps the answers already recorded for the rest
+	std::map<PuzzleKey, std::string> recordedAnswers;
+	if (!options.RecordAnswersFilename.empty() && std::filesystem::exists(options.RecordAnswersFilename))
+	{
+		recordedAnswers = LoadAnswers(options.RecordAnswersFilename);
+	}
+
+	for (size_t i = 0; i < ordered.size(); i++)
+	{
+		if (solved[i])
+		{
+			timings[GetPuzzleKey(*ordered[i])] = milliseconds[i];
+			recordedAnswers[GetPuzzleKey(*ordered[i])] = answers[i];
+		}
+	}
+	SaveTimings(options.TimingsFilename, timings);
+	ReleasePuzzleModels();
+
+	if (!options.RecordAnswersFilename.empty())
+	{
+		SaveAnswers(options.RecordAnswersFilename, recordedAnswers);
+	}
+
+	if (verifying)
+	{
+		int64_t skippedCount = (int64_t)ordered.size() - matchedCount - mismatchedCount - uncheckedCount - missingCount;
+		printf("Verified %" PRId64 " answers: %" PRId64 " matched, %" PRId64 " mismatched, %" PRId64 " with no expected answer, %" PRId64 " missing input, %" PRId64 " skipped\n",
+			(int64_t)ordered.size(), matchedCount, mismatchedCount, uncheckedCount, missingCount, skippedCount);
+		return !failed && (missingCount == 0);
+	}
+	return !failed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+std::vector<PuzzleBenchmarkResult> BenchmarkPuzzles(const std::vector<PuzzleEntry>& puzzles, const PuzzleBenchmarkOptions& options)
+{
+	// Keep file reads out of the timings
+	std::vector<std::string> inputFilenames;
+	for (const PuzzleEntry& puzzle : puzzles)
+	{
+		inputFilenames.push_back(GetPuzzleInputFilename(options.InputDirectory, puzzle));
+	}
+	PreloadPuzzleInputs(inputFilenames);
+
+	std::vector<PuzzleBenchmarkResult> results;
+	for (const PuzzleEntry& puzzle : puzzles)
+	{
+		if (!GetPuzzleInputData(GetPuzzleInputFilename(options.InputDirectory, puzzle))->Found)
+		{
+			PuzzleBenchmarkResult result;
+			result.Puzzle = &puzzle;
+			result.InputMissing = true;
+			results.push_back(std::move(result));
+			continue;
+		}
+
+		std::string output;
+		std::string answer;
+		for (int64_t i = 0; i < options.WarmupCount; i++)
+		{
+			BeginPuzzleRunGeneration();
+			output.clear();
+			SolvePuzzle(puzzle, options.InputDirectory, &output, &answer);
+		}
+
+		std::optional<PerfCounters> counters;
+		if (options.CollectCounters)
+		{
+			counters.emplace();
+		}
+
+		std::vector<double> milliseconds;
+		std::vector<PerfCounterValues> counterValues;
+		AllocationStats allocationTotals;
+		for (int64_t i = 0; i < std::max<int64_t>(options.RepeatCount, 1); i++)
+		{
+			BeginPuzzleRunGeneration();
+			output.clear();
+			if (counters)
+			{
+				counters->Start();
+			}
+			AllocationStats allocations;
+			milliseconds.push_back(SolvePuzzle(puzzle, options.InputDirectory, &output, &answer, &allocations));
+			allocationTotals.Allocations += allocations.Allocations;
+			allocationTotals.Bytes += allocations.Bytes;
+			allocationTotals.PeakLiveBytes = std::max(allocationTotals.PeakLiveBytes, allocations.PeakLiveBytes);
+			if (counters)
+			{
+				counterValues.push_back(counters->Stop());
+			}
+		}
+		std::sort(milliseconds.begin(), milliseconds.end());
+
+		PuzzleBenchmarkResult result;
+		result.Puzzle = &puzzle;
+		result.RunCount = (int64_t)milliseconds.size();
+		result.Allocations.Allocations = allocationTotals.Allocations / result.RunCount;
+		result.Allocations.Bytes = allocationTotals.Bytes / result.RunCount;
+		result.Allocations.PeakLiveBytes = allocationTotals.PeakLiveBytes;
+		result.MinMilliseconds = milliseconds.front();
+		result.MedianMilliseconds = milliseconds[milliseconds.size() / 2];
+		result.P95Milliseconds = milliseconds[(milliseconds.size() * 95 + 99) / 100 - 1];
+
+		result.InputBytes = (int64_t)GetPuzzleInput(GetPuzzleInputFilename(options.InputDirectory, puzzle)).size();
+		result.BytesPerSecond = (result.MedianMilliseconds > 0.0) ? (double)result.InputBytes * 1000.0 / result.MedianMilliseconds : 0.0;
+
+		if (!counterValues.empty())
+		{
+			auto mean = [&](int64_t PerfCounterValues::* field)
+				{
+					int64_t total = 0;
+					for (const PerfCounterValues& values : counterValues)
+					{
+						if (values.*field < 0)
+							return int64_t{ -1 };
+						total += values.*field;
+					}
+					return total / (int64_t)counterValues.size();
+				};
+			result.Counters.Cycles = mean(&PerfCounterValues::Cycles);
+			result.Counters.Instructions = mean(&PerfCounterValues::Instructions);
+			result.Counters.CacheMisses = mean(&PerfCounterValues::CacheMisses);
+			result.Counters.BranchMisses = mean(&PerfCounterValues::BranchMisses);
+			result.Counters.PageFaults = mean(&PerfCounterValues::PageFaults);
+		}
+
+		result.Answer = std::move(answer);
+		results.push_back(std::move(result));
+	}
+	ReleasePuzzleModels();
+	return results;
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "AllocationTracking.h"
+#include "PerfCounters.h"
+#include "Profile.h"
+#include "PuzzleArena.h"
+#include "PuzzleInput.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Puzzles print through this rather than printf. While the runner is solving a puzzle the text is
+// buffered for that puzzle, so puzzles running in parallel still print in a tidy order.
+void PuzzlePrintf(const char* format, ...);
+
+//////////////////////////////////////////////////////////////////////////
+
+class IPuzzleModelCache;
+
+struct PuzzleEntry
+{
+	int64_t Year = 0;
+	int64_t Day = 0;
+	char Part = 'A';
+
+	// Takes the input filename and returns the answer as text
+	std::function<std::string(const std::string&)> Solve;
+
+	// Set for parts registered with REGISTER_PARSED_PUZZLE; parts with the same cache share a parse
+	IPuzzleModelCache* ModelCache = nullptr;
+};
+
+// Returns true so it can initialise a static; see REGISTER_PUZZLE
+bool RegisterPuzzle(int64_t year, int64_t day, char part, std::function<std::string(const std::string&)> solve, IPuzzleModelCache* modelCache = nullptr);
+const std::vector<PuzzleEntry>& GetRegisteredPuzzles();
+
+// Input files live at <root>/AoC<year>/Puzzle<day>.txt, with the separator native to the platform
+std::string GetPuzzleInputFilename(const std::string& rootDirectory, const PuzzleEntry& puzzle);
+
+#define PUZZLE_CONCAT_INNER(a, b) a##b
+#define PUZZLE_CONCAT(a, b) PUZZLE_CONCAT_INNER(a, b)
+
+// Parts may answer with any number or anything a std::string can be built from
+template <typename T>
+std::string FormatPuzzleAnswer(const T& answer)
+{
+	if constexpr (std::is_arithmetic_v<T>)
+		return std::to_string(answer);
+	else
+		return std::string(answer);
+}
+
+// Adds one part of a puzzle to the registry during static initialisation, e.g.
+// REGISTER_PUZZLE(2023, 5, A, Puzzle05_A);
+#define REGISTER_PUZZLE(year, day, part, fn) \
+	static const bool PUZZLE_CONCAT(s_puzzleRegistered_, __LINE__) = RegisterPuzzle(year, day, (#part)[0], \
+		[](const std::string& filename) { return FormatPuzzleAnswer(fn(filename)); })
+
+//////////////////////////////////////////////////////////////////////////
+
+// Parsed models are kept for one run generation. RunPuzzles uses a single generation so the
+// parts of a day share one parse, and releases each model once its parts have finished;
+// benchmarks start a new generation per run so each is timed in full.
+uint64_t GetPuzzleRunGeneration();
+void BeginPuzzleRunGeneration();
+
+class IPuzzleModelCache
+{
+public:
+	virtual ~IPuzzleModelCache() = default;
+	virtual void Release() = 0;
+};
+
+void RegisterPuzzleModelCache(IPuzzleModelCache* cache);
+
+// Frees every cached model
+void ReleasePuzzleModels();
+
+// Holds the model made by one Parse function. Whichever part asks first parses while holding
+// the lock, so another part asking at the same time waits rather than parsing a second time.
+// RunPuzzles runs the parts sharing a cache one after another, so none of its workers wait.
+template <auto Parse>
+class PuzzleModelCache : public IPuzzleModelCache
+{
+public:
+	using Model = std::remove_cvref_t<std::invoke_result_t<decltype(Parse), std::string_view>>;
+
+	static PuzzleModelCache& Get()
+	{
+		static PuzzleModelCache cache;
+		return cache;
+	}
+
+	std::shared_ptr<const Model> GetModel(const std::string& filename)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		uint64_t generation = GetPuzzleRunGeneration();
+		if ((m_model == nullptr) || (m_generation != generation) || (m_filename != filename))
+		{
+			PROFILE_SCOPE("Parse");
+
+			// The model outlives the part that asked for it, so it mustn't be built in that part's arena
+			PuzzleArenaScope noArena(nullptr);
+			m_model = std::make_shared<const Model>(Parse(GetPuzzleInput(filename)));
+			m_generation = generation;
+			m_filename = filename;
+		}
+		return m_model;
+	}
+
+	void Release() override
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_model.reset();
+	}
+
+private:
+	PuzzleModelCache()
+	{
+		RegisterPuzzleModelCache(this);
+	}
+
+	std::mutex m_mutex;
+	std::shared_ptr<const Model> m_model;
+	uint64_t m_generation = 0;
+	std::string m_filename;
+};
+
+// Like REGISTER_PUZZLE, for parts that share a parse step:
+//   static Model Parse(string_view input);
+//   static int64_t Puzzle05_A(const Model& model);
+//   REGISTER_PARSED_PUZZLE(2023, 5, A, Parse, Puzzle05_A);
+#define REGISTER_PARSED_PUZZLE(year, day, part, parse, fn) \
+	static const bool PUZZLE_CONCAT(s_puzzleRegistered_, __LINE__) = RegisterPuzzle(year, day, (#part)[0], \
+		[](const std::string& filename) { return FormatPuzzleAnswer(fn(*PuzzleModelCache<parse>::Get().GetModel(filename))); }, \
+		&PuzzleModelCache<parse>::Get())
+
+//////////////////////////////////////////////////////////////////////////
+
+struct PuzzleRunOptions
+{
+	// Zero means one thread per core
+	int64_t ThreadCount = 0;
+
+	// Root for GetPuzzleInputFilename
+	std::string InputDirectory = ".";
+
+	// Wall times from earlier runs, used to start the slowest puzzles first, and updated with this
+	// run's. Empty, the default, to schedule in puzzle order and write nothing.
+	std::string TimingsFilename;
+
+	// Answers known to be right, one "year day part answer" per line. When set, every answer is
+	// checked and the first mismatch stops any puzzles that haven't started yet; those are listed
+	// as skipped.
+	std::string ExpectedAnswersFilename;
+
+	// Writes every answer from this run in the same format, ready to use as expected answers
+	std::string RecordAnswersFilename;
+};
+
+// Solves one puzzle part on the calling thread, appending anything it prints to output rather
+// than stdout. Returns the wall time in milliseconds. Allocation counts are only non-zero in
+// builds with AOC_TRACK_ALLOCATIONS.
+double SolvePuzzle(const PuzzleEntry& puzzle, const std::string& inputDirectory, std::string* output, std::string* answer, AllocationStats* allocations = nullptr);
+
+// Solves every puzzle part across a work-stealing pool and prints each part's output and answer
+// in year, day and part order as soon as everything before it has finished. Parts sharing a
+// parsed model run back to back on one worker, and the model is freed when they're done. Parts whose input
+// is missing are flagged and not run. Returns false if any answer didn't match the expected
+// answers, or when verifying, if any part couldn't be run for want of its input.
+bool RunPuzzles(const std::vector<PuzzleEntry>& puzzles, const PuzzleRunOptions& options = {});
+
+//////////////////////////////////////////////////////////////////////////
+
+struct PuzzleBenchmarkOptions
+{
+	// Untimed runs before the timed ones, to warm caches and the allocator
+	int64_t WarmupCount = 1;
+	int64_t RepeatCount = 10;
+
+	// Also count cycles, instructions, cache misses, branch misses and page faults
+	bool CollectCounters = false;
+
+	std::string InputDirectory = ".";
+};
+
+struct PuzzleBenchmarkResult
+{
+	const PuzzleEntry* Puzzle = nullptr;
+	int64_t RunCount = 0;
+	double MinMilliseconds = 0.0;
+	double MedianMilliseconds = 0.0;
+	double P95Milliseconds = 0.0;
+
+	// Throughput is measured against the median time
+	int64_t InputBytes = 0;
+	double BytesPerSecond = 0.0;
+
+	// Mean per timed run; only filled in when CollectCounters is set
+	PerfCounterValues Counters;
+
+	// Mean allocations and bytes per timed run, and the highest peak of any run
+	AllocationStats Allocations;
+
+	// The answer from the last timed run
+	std::string Answer;
+
+	// The input file couldn't be opened, so the part wasn't run and RunCount is zero
+	bool InputMissing = false;
+};
+
+// Times each puzzle part one after another on the calling thread, so runs don't compete for cores
+std::vector<PuzzleBenchmarkResult> BenchmarkPuzzles(const std::vector<PuzzleEntry>& puzzles, const PuzzleBenchmarkOptions& options);
+
+//////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,7 @@
 
 std::vector<std::string> StringSplit(std::string source, char delim)
 {
+	PROFILE_SCOPE("StringSplit");
 	std::vector<std::string> splits;
 	splits.reserve((source.size() / 3) + 1);
 	while (source.size())
@@ -28,6 +29,7 @@ std::vector<std::string> StringSplit(std::string source, char delim)
 
 std::vector<std::string> StringSplitTrimmed(std::string source, char delim)
 {
+	PROFILE_SCOPE("StringSplitTrimmed");
 	std::vector<std::string> splits;
 	splits.reserve((source.size() / 3) + 1);
 	while (source.size())
@@ -115,3 +117,27 @@ AllUnorderedPairsRange AllUnorderedPairs(int64_t size)
 {
 	return AllUnorderedPairsRange{ size };
 }
+
+std::vector<UnorderedPairTile> AllUnorderedPairTiles(int64_t size, int64_t tileSize)
+{
+	assert(tileSize > 0);
+
+	std::vector<UnorderedPairTile> tiles;
+	int64_t tileCount = (size + tileSize - 1) / tileSize;
+	tiles.reserve((tileCount * (tileCount + 1)) / 2);
+
+	for (int64_t row = 0; row < tileCount; row++)
+	{
+		for (int64_t column = row; column < tileCount; column++)
+		{
+			UnorderedPairTile tile;
+			tile.RowBegin = row * tileSize;
+			tile.RowEnd = std::min(tile.RowBegin + tileSize, size);
+			tile.ColumnBegin = column * tileSize;
+			tile.ColumnEnd = std::min(tile.ColumnBegin + tileSize, size);
+			tiles.push_back(tile);
+		}
+	}
+
+	return tiles;
+}
@@ -1,22 +1,36 @@
 #pragma once
 
 #include "Enumerable.h"
+#include "Hashing.h"
 #include "Point2.h"
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix43.h"
+#include "Vector3Cloud.h"
 #include "ArrayMap2D.h"
 #include "PointMap.h"
 #include "MD5.h"
 #include "NameDictionary.h"
 #include "FileInput.h"
+#include "PuzzleInput.h"
 #include "Hex.h"
 #include "PointIteration.h"
+#include "Generator.h"
+#include "Parallel.h"
+#include "CpuFeatures.h"
+#include "AllocationTracking.h"
+#include "Profile.h"
+#include "PerfCounters.h"
+#include "PuzzleArena.h"
+#include "PuzzleRunner.h"
+#include "PuzzleCommandLine.h"
+#include "FlatPointMap.h"
 
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <spanstream>
 #include <map>
 #include <set>
 #include <stack>
@@ -30,6 +44,7 @@
 #include <array>
 #include <ranges>
 #include <bit>
+#include <optional>
 
 #include <assert.h>
 #include <inttypes.h>
@@ -149,6 +164,74 @@ static_assert(std::ranges::input_range<InputLineRange>);
 
 AllUnorderedPairsRange AllUnorderedPairs(int64_t size);
 
+// Square block of the (i < j) pair triangle; blocks on the diagonal only contain their upper half
+struct UnorderedPairTile
+{
+	int64_t RowBegin = 0;
+	int64_t RowEnd = 0;
+	int64_t ColumnBegin = 0;
+	int64_t ColumnEnd = 0;
+
+	// func(i, jBegin, jEnd) gets a contiguous run of j for each row, for loops the compiler can vectorise
+	template <typename FUNC>
+	void ForEachRow(FUNC&& func) const
+	{
+		for (int64_t i = RowBegin; i < RowEnd; i++)
+		{
+			int64_t jBegin = std::max(ColumnBegin, i + 1);
+			if (jBegin < ColumnEnd)
+			{
+				func(i, jBegin, ColumnEnd);
+			}
+		}
+	}
+
+	template <typename FUNC>
+	void ForEachPair(FUNC&& func) const
+	{
+		ForEachRow([&func](int64_t i, int64_t jBegin, int64_t jEnd)
+			{
+				for (int64_t j = jBegin; j < jEnd; j++)
+				{
+					func(i, j);
+				}
+			});
+	}
+};
+
+std::vector<UnorderedPairTile> AllUnorderedPairTiles(int64_t size, int64_t tileSize = 256);
+
+template <typename FUNC>
+void ForEachUnorderedPairTiled(int64_t size, FUNC&& func, int64_t tileSize = 256)
+{
+	for (const UnorderedPairTile& tile : AllUnorderedPairTiles(size, tileSize))
+	{
+		tile.ForEachPair(func);
+	}
+}
+
+// func(i, jBegin, jEnd) may be called concurrently from several threads
+template <typename FUNC>
+void ParallelForEachUnorderedPairRow(int64_t size, FUNC&& func, int64_t tileSize = 256)
+{
+	std::vector<UnorderedPairTile> tiles = AllUnorderedPairTiles(size, tileSize);
+	ParallelFor((int64_t)tiles.size(), [&tiles, &func](int64_t tileIndex, int64_t)
+		{
+			tiles[tileIndex].ForEachRow(func);
+		});
+}
+
+// func(i, j) may be called concurrently from several threads
+template <typename FUNC>
+void ParallelForEachUnorderedPair(int64_t size, FUNC&& func, int64_t tileSize = 256)
+{
+	std::vector<UnorderedPairTile> tiles = AllUnorderedPairTiles(size, tileSize);
+	ParallelFor((int64_t)tiles.size(), [&tiles, &func](int64_t tileIndex, int64_t)
+		{
+			tiles[tileIndex].ForEachPair(func);
+		});
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 template <typename VALUE_TYPE>
@@ -182,62 +265,127 @@ struct ICustomIteratorTest : ICustomIterator<char>
 	}
 };
 
-template <typename CUSTOM_TYPE>
-struct CustomIterator
+namespace CustomIteratorStorage
 {
-	using value_type = CUSTOM_TYPE::value_type;
-	using difference_type = ptrdiff_t;
+	// Iterator states up to this size live inline in the iterator, larger ones are shared copy-on-write
+	constexpr size_t InlineStateSize = 64;
 
-	value_type Current = {};
+	template <typename CUSTOM_TYPE, bool INLINE = (sizeof(CUSTOM_TYPE) <= InlineStateSize)>
+	class State;
 
-	CustomIterator() = default;
-	explicit CustomIterator(const std::shared_ptr<CUSTOM_TYPE> &iterator)
-		: Iterator(iterator)
+	template <typename CUSTOM_TYPE>
+	class State<CUSTOM_TYPE, true>
 	{
-		if (Iterator)
+	public:
+		State() = default;
+
+		template <typename... ARGS>
+		explicit State(std::in_place_t, ARGS&&... args)
+			: Value(std::in_place, std::forward<ARGS>(args)...)
 		{
-			NextValue = Iterator->Ctor(&Current);
 		}
-	}
 
-	CustomIterator(const CustomIterator& other)
-		: Current(other.Current)
-		, NextValue(other.NextValue)
-		, Iterator(other.Iterator ? std::make_shared<CUSTOM_TYPE>(*other.Iterator) : nullptr)
-	{
-	}
+		bool HasValue() const
+		{
+			return Value.has_value();
+		}
 
-	CustomIterator(const CustomIterator&& other) noexcept
-		: Current(std::move(other.Current))
-		, NextValue(other.NextValue)
-		, Iterator(std::move(other.Iterator))
-	{
-	}
+		const CUSTOM_TYPE& Get() const
+		{
+			return *Value;
+		}
+
+		CUSTOM_TYPE& GetMutable()
+		{
+			return *Value;
+		}
 
-	CustomIterator &operator=(const CustomIterator& other)
+		void Release()
+		{
+			Value.reset();
+		}
+
+	private:
+		std::optional<CUSTOM_TYPE> Value;
+	};
+
+	template <typename CUSTOM_TYPE>
+	class State<CUSTOM_TYPE, false>
 	{
-		Current = other.Current;
-		NextValue = other.NextValue;
-		Iterator = other.Iterator ? std::make_shared<CUSTOM_TYPE>(*other.Iterator) : nullptr;
-	}
+	public:
+		State() = default;
+
+		template <typename... ARGS>
+		explicit State(std::in_place_t, ARGS&&... args)
+			: Value(std::make_shared<CUSTOM_TYPE>(std::forward<ARGS>(args)...))
+		{
+		}
+
+		bool HasValue() const
+		{
+			return Value != nullptr;
+		}
 
-	CustomIterator &operator=(const CustomIterator&& other)
+		const CUSTOM_TYPE& Get() const
+		{
+			return *Value;
+		}
+
+		CUSTOM_TYPE& GetMutable()
+		{
+			// Only pay for the deep copy when another iterator is still looking at this state
+			if (Value.use_count() > 1)
+			{
+				Value = std::make_shared<CUSTOM_TYPE>(*Value);
+			}
+			return *Value;
+		}
+
+		void Release()
+		{
+			Value.reset();
+		}
+
+	private:
+		std::shared_ptr<CUSTOM_TYPE> Value;
+	};
+}
+
+// Custom types of up to InlineStateSize bytes live inside the iterator, so every copy of the
+// iterator copies them too. Larger ones are shared between copies until one of them advances.
+// It's only an input iterator either way: operator* refers to a value held in the iterator
+// itself, and ICustomIterator's equality doesn't compare any state.
+template <typename CUSTOM_TYPE>
+struct CustomIterator
+{
+	using value_type = CUSTOM_TYPE::value_type;
+	using difference_type = ptrdiff_t;
+	using iterator_concept = std::input_iterator_tag;
+	using iterator_category = std::input_iterator_tag;
+
+	value_type Current = {};
+
+	CustomIterator() = default;
+
+	template <typename... ARGS>
+	explicit CustomIterator(std::in_place_t, ARGS&&... args)
+		: Iterator(std::in_place, std::forward<ARGS>(args)...)
 	{
-		Current = std::move(other.Current);
-		NextValue = other.NextValue;
-		Iterator = std::move(other.Iterator);
+		NextValue = Iterator.GetMutable().Ctor(&Current);
+		ReleaseIfFinished();
 	}
 
 	CustomIterator& operator++()
 	{
-		NextValue = Iterator->Next(&Current);
+		NextValue = Iterator.GetMutable().Next(&Current);
+		ReleaseIfFinished();
 		return *this;
 	}
 
 	CustomIterator operator++(int)
 	{
-		CustomIterator copy(std::make_unique<CUSTOM_TYPE>(*Iterator));
-		NextValue = Iterator->Next(&Current);
+		CustomIterator copy(*this);
+		++(*this);
 		return copy;
 	}
 
@@ -253,11 +401,11 @@ struct CustomIterator
 
 	bool operator==(const CustomIterator& other) const
 	{
-		bool thisIsEndSentinel = (NextValue == ICustomIterator<value_type>::NextValueResult::NoMoreValues) || !Iterator;
-		bool otherIsEndSentinel = (other.NextValue == ICustomIterator<value_type>::NextValueResult::NoMoreValues) || !other.Iterator;
+		bool thisIsEndSentinel = IsEndSentinel();
+		bool otherIsEndSentinel = other.IsEndSentinel();
 		bool bothEndSentinels = (thisIsEndSentinel && otherIsEndSentinel);
 		bool neitherAreEndSentinels = (!thisIsEndSentinel && !otherIsEndSentinel);
-		return bothEndSentinels || (neitherAreEndSentinels && (*Iterator == *other.Iterator));
+		return bothEndSentinels || (neitherAreEndSentinels && (Iterator.Get() == other.Iterator.Get()));
 	}
 
 	bool operator!=(const CustomIterator& other) const
@@ -266,17 +414,30 @@ struct CustomIterator
 	}
 
 private:
+	bool IsEndSentinel() const
+	{
+		return (NextValue == ICustomIterator<value_type>::NextValueResult::NoMoreValues) || !Iterator.HasValue();
+	}
+
+	void ReleaseIfFinished()
+	{
+		if (NextValue == ICustomIterator<value_type>::NextValueResult::NoMoreValues)
+		{
+			Iterator.Release();
+		}
+	}
+
 	ICustomIterator<value_type>::NextValueResult NextValue = ICustomIterator<value_type>::NextValueResult::NoMoreValues;
-	std::shared_ptr<CUSTOM_TYPE> Iterator;
+	CustomIteratorStorage::State<CUSTOM_TYPE> Iterator;
 };
 
-static_assert(std::input_or_output_iterator<CustomIterator<ICustomIteratorTest>>);
+static_assert(std::input_iterator<CustomIterator<ICustomIteratorTest>>);
 
 template <typename ITERATOR_TYPE, typename... ARGS>
 std::ranges::subrange<CustomIterator<ITERATOR_TYPE>> CustomRange(ARGS&&... args)
 {
 	return std::ranges::subrange<CustomIterator<ITERATOR_TYPE>>(
-		CustomIterator<ITERATOR_TYPE>{ std::make_shared<ITERATOR_TYPE>(std::forward<ARGS>(args)...) },
+		CustomIterator<ITERATOR_TYPE>{ std::in_place, std::forward<ARGS>(args)... },
 		CustomIterator<ITERATOR_TYPE>{}
 		);
 }
@@ -286,42 +447,260 @@ static_assert(std::ranges::input_range<decltype(CustomRange<ICustomIteratorTest>
 //////////////////////////////////////////////////////////////////////////
 
 template <typename ID>
+concept StdHashable = requires(const ID& id) { { std::hash<ID>{}(id) } -> std::convertible_to<size_t>; };
+
+// Counts per id in a flat hash table, with an indexed max-heap over the counts so the most
+// common id is known after any mix of increments and decrements. Ties go to the id whose count
+// reached that value first. Ids with no std::hash, such as pairs and tuples, fall back to an
+// ordered index needing only operator<; pass a hash such as PairHash to keep the flat table.
+template <typename ID, typename HASH = std::conditional_t<StdHashable<ID>, std::hash<ID>, void>>
 class MostCounter
 {
 public:
 
 	void AddCount(const ID& id, int64_t count = 1);
+	int64_t GetCount(const ID& id) const;
 	ID GetMostId() const;
 	int64_t GetMostCount() const;
+	std::vector<std::pair<ID, int64_t>> GetTopCounts(size_t k) const;
+	size_t Size() const { return Entries.size(); }
+	void Reserve(size_t count);
 
 private:
 
-	std::pair<ID, int64_t> CurrentMost = { {}, -1 };
-	std::map<ID, int64_t> Counts;
+	struct Entry
+	{
+		ID Id;
+		int64_t Count = 0;
+		size_t HeapIndex = 0;
+
+		// When Count last changed, for breaking ties
+		uint64_t ChangedAt = 0;
+	};
+
+	static constexpr bool Ordered = std::is_void_v<HASH>;
+
+	static constexpr size_t EmptySlot = SIZE_MAX;
 
+	size_t FindSlot(const ID& id) const;
+	size_t FindOrAddEntry(const ID& id);
+	void Rehash(size_t slotCount);
+	bool HeapBefore(size_t entryA, size_t entryB) const;
+	void SiftUp(size_t heapIndex);
+	void SiftDown(size_t heapIndex);
+	void SwapHeap(size_t heapA, size_t heapB);
+
+	// Slots hold entry indices; a power-of-two count so probing can mask
+	std::vector<size_t> Slots;
+	std::vector<Entry> Entries;
+	std::vector<size_t> Heap;
+	int SlotShift = 64;
+	uint64_t ChangeCount = 0;
+
+	// Used instead of Slots when there's no hash for ID
+	std::map<ID, size_t> OrderedIndex;
 };
 
-template<typename ID>
-inline void MostCounter<ID>::AddCount(const ID& id, int64_t count)
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::AddCount(const ID& id, int64_t count)
+{
+	size_t entryIndex = FindOrAddEntry(id);
+	Entry& entry = Entries[entryIndex];
+	entry.Count += count;
+	entry.ChangedAt = ++ChangeCount;
+	if (count > 0)
+	{
+		SiftUp(entry.HeapIndex);
+	}
+	else
+	{
+		SiftDown(entry.HeapIndex);
+	}
+}
+
+template<typename ID, typename HASH>
+inline int64_t MostCounter<ID, HASH>::GetCount(const ID& id) const
+{
+	if constexpr (Ordered)
+	{
+		auto entry = OrderedIndex.find(id);
+		return (entry == OrderedIndex.end()) ? 0 : Entries[entry->second].Count;
+	}
+	else
+	{
+		size_t slot = FindSlot(id);
+		return ((slot == EmptySlot) || (Slots[slot] == EmptySlot)) ? 0 : Entries[Slots[slot]].Count;
+	}
+}
+
+template<typename ID, typename HASH>
+inline ID MostCounter<ID, HASH>::GetMostId() const
+{
+	return Heap.empty() ? ID{} : Entries[Heap[0]].Id;
+}
+
+template<typename ID, typename HASH>
+inline int64_t MostCounter<ID, HASH>::GetMostCount() const
+{
+	return Heap.empty() ? -1 : Entries[Heap[0]].Count;
+}
+
+template<typename ID, typename HASH>
+inline std::vector<std::pair<ID, int64_t>> MostCounter<ID, HASH>::GetTopCounts(size_t k) const
+{
+	// Walk the heap best-first with a small frontier heap, so this costs O(k log k)
+	std::vector<std::pair<ID, int64_t>> topCounts;
+	std::vector<size_t> frontier;
+	auto frontierLess = [this](size_t heapA, size_t heapB) { return HeapBefore(Heap[heapB], Heap[heapA]); };
+	if (!Heap.empty())
+	{
+		frontier.push_back(0);
+	}
+
+	while (!frontier.empty() && (topCounts.size() < k))
+	{
+		std::pop_heap(frontier.begin(), frontier.end(), frontierLess);
+		size_t heapIndex = frontier.back();
+		frontier.pop_back();
+
+		const Entry& entry = Entries[Heap[heapIndex]];
+		topCounts.emplace_back(entry.Id, entry.Count);
+		for (size_t child = (heapIndex * 2) + 1; (child <= (heapIndex * 2) + 2) && (child < Heap.size()); child++)
+		{
+			frontier.push_back(child);
+			std::push_heap(frontier.begin(), frontier.end(), frontierLess);
+		}
+	}
+	return topCounts;
+}
+
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::Reserve(size_t count)
+{
+	Entries.reserve(count);
+	Heap.reserve(count);
+	if constexpr (!Ordered)
+	{
+		size_t slotCount = std::bit_ceil(std::max<size_t>((count * 4) / 3 + 1, 16));
+		if (slotCount > Slots.size())
+		{
+			Rehash(slotCount);
+		}
+	}
+}
+
+template<typename ID, typename HASH>
+inline size_t MostCounter<ID, HASH>::FindSlot(const ID& id) const
+{
+	if (Slots.empty())
+		return EmptySlot;
+
+	// Fibonacci hashing spreads weak hashes (such as identity hashes of integers) over the table
+	size_t mask = Slots.size() - 1;
+	size_t slot = (size_t)(((uint64_t)HASH{}(id) * 0x9e3779b97f4a7c15ull) >> SlotShift);
+	while ((Slots[slot] != EmptySlot) && !(Entries[Slots[slot]].Id == id))
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+template<typename ID, typename HASH>
+inline size_t MostCounter<ID, HASH>::FindOrAddEntry(const ID& id)
 {
-	int64_t newCount = (Counts[id] += count);
-	if (newCount > CurrentMost.second)
+	if constexpr (Ordered)
 	{
-		CurrentMost.first = id;
-		CurrentMost.second = newCount;
+		auto [entry, inserted] = OrderedIndex.try_emplace(id, Entries.size());
+		if (inserted)
+		{
+			Entries.push_back({ id, 0, Heap.size() });
+			Heap.push_back(entry->second);
+		}
+		return entry->second;
+	}
+	else
+	{
+		size_t slot = FindSlot(id);
+		if ((slot != EmptySlot) && (Slots[slot] != EmptySlot))
+			return Slots[slot];
+
+		if ((Entries.size() + 1) * 4 > Slots.size() * 3)
+		{
+			Rehash(std::max<size_t>(Slots.size() * 2, 16));
+			slot = FindSlot(id);
+		}
+
+		size_t entryIndex = Entries.size();
+		Slots[slot] = entryIndex;
+		Entries.push_back({ id, 0, Heap.size() });
+		Heap.push_back(entryIndex);
+		return entryIndex;
 	}
 }
 
-template<typename ID>
-inline ID MostCounter<ID>::GetMostId() const
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::Rehash(size_t slotCount)
 {
-	return CurrentMost.first;
+	Slots.assign(slotCount, EmptySlot);
+	SlotShift = 64 - std::countr_zero(slotCount);
+	for (size_t entryIndex = 0; entryIndex < Entries.size(); entryIndex++)
+	{
+		Slots[FindSlot(Entries[entryIndex].Id)] = entryIndex;
+	}
+}
+
+template<typename ID, typename HASH>
+inline bool MostCounter<ID, HASH>::HeapBefore(size_t entryA, size_t entryB) const
+{
+	int64_t countA = Entries[entryA].Count;
+	int64_t countB = Entries[entryB].Count;
+	return (countA > countB) || ((countA == countB) && (Entries[entryA].ChangedAt < Entries[entryB].ChangedAt));
+}
+
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::SiftUp(size_t heapIndex)
+{
+	while (heapIndex > 0)
+	{
+		size_t parent = (heapIndex - 1) / 2;
+		if (!HeapBefore(Heap[heapIndex], Heap[parent]))
+			break;
+
+		SwapHeap(heapIndex, parent);
+		heapIndex = parent;
+	}
+}
+
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::SiftDown(size_t heapIndex)
+{
+	for (;;)
+	{
+		size_t best = heapIndex;
+		size_t left = (heapIndex * 2) + 1;
+		size_t right = left + 1;
+		if ((left < Heap.size()) && HeapBefore(Heap[left], Heap[best]))
+		{
+			best = left;
+		}
+		if ((right < Heap.size()) && HeapBefore(Heap[right], Heap[best]))
+		{
+			best = right;
+		}
+		if (best == heapIndex)
+			break;
+
+		SwapHeap(heapIndex, best);
+		heapIndex = best;
+	}
 }
 
-template<typename ID>
-inline int64_t MostCounter<ID>::GetMostCount() const
+template<typename ID, typename HASH>
+inline void MostCounter<ID, HASH>::SwapHeap(size_t heapA, size_t heapB)
 {
-	return CurrentMost.second;
+	std::swap(Heap[heapA], Heap[heapB]);
+	Entries[Heap[heapA]].HeapIndex = heapA;
+	Entries[Heap[heapB]].HeapIndex = heapB;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,204 @@
+#include "stdafx.h"
+#include "Vector3Cloud.h"
+#include "CpuFeatures.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// MSVC allows AVX2 intrinsics anywhere, GCC and Clang only in functions marked for AVX2
+#if defined(_M_X64) || defined(__x86_64__)
+#define VECTOR3CLOUD_USE_AVX2 1
+#if defined(_MSC_VER)
+#define VECTOR3CLOUD_AVX2_TARGET
+#else
+#define VECTOR3CLOUD_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+	// One output axis of a signed permutation matrix: dest = +/-source + offset
+	struct AxisSelect
+	{
+		int Source;
+		int64_t SignMask;
+		int64_t Offset;
+	};
+
+	bool TryGetAxisSelects(const Matrix43& m, std::array<AxisSelect, 3>* selects)
+	{
+		const int64_t columns[3][3] = {
+			{ m.m00, m.m10, m.m20 },
+			{ m.m01, m.m11, m.m21 },
+			{ m.m02, m.m12, m.m22 },
+		};
+		const int64_t offsets[3] = { m.m30, m.m31, m.m32 };
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			int source = -1;
+			for (int row = 0; row < 3; row++)
+			{
+				int64_t value = columns[axis][row];
+				if (value == 0)
+					continue;
+
+				if ((source >= 0) || ((value != 1) && (value != -1)))
+					return false;
+
+				source = row;
+			}
+			if (source < 0)
+				return false;
+
+			(*selects)[axis] = { source, (columns[axis][source] < 0) ? -1 : 0, offsets[axis] };
+		}
+		return true;
+	}
+
+	void SelectAxisScalar(const int64_t* source, const AxisSelect& select, int64_t* dest, size_t begin, size_t end)
+	{
+		// (v ^ mask) - mask negates when the mask is all ones
+		for (size_t i = begin; i < end; i++)
+		{
+			dest[i] = ((source[i] ^ select.SignMask) - select.SignMask) + select.Offset;
+		}
+	}
+
+#if defined(VECTOR3CLOUD_USE_AVX2)
+	VECTOR3CLOUD_AVX2_TARGET size_t SelectAxisAVX2(const int64_t* source, const AxisSelect& select, int64_t* dest, size_t count)
+	{
+		__m256i signMask = _mm256_set1_epi64x(select.SignMask);
+		__m256i offset = _mm256_set1_epi64x(select.Offset);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+			__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 4));
+			a = _mm256_add_epi64(_mm256_sub_epi64(_mm256_xor_si256(a, signMask), signMask), offset);
+			b = _mm256_add_epi64(_mm256_sub_epi64(_mm256_xor_si256(b, signMask), signMask), offset);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), a);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i + 4), b);
+		}
+		return i;
+	}
+#endif
+
+	void SelectAxis(const int64_t* source, const AxisSelect& select, int64_t* dest, size_t count)
+	{
+		size_t done = 0;
+#if defined(VECTOR3CLOUD_USE_AVX2)
+		static const bool useAVX2 = CpuSupportsAVX2();
+		if (useAVX2)
+		{
+			done = SelectAxisAVX2(source, select, dest, count);
+		}
+#endif
+		SelectAxisScalar(source, select, dest, done, count);
+	}
+
+	// AVX2 has no 64-bit multiply, so general matrices stay scalar and are left to the compiler
+	void TransformAxisGeneral(const Vector3Cloud& in, int64_t mx, int64_t my, int64_t mz, int64_t offset, int64_t* dest)
+	{
+		const int64_t* x = in.X.data();
+		const int64_t* y = in.Y.data();
+		const int64_t* z = in.Z.data();
+		size_t count = in.Size();
+		for (size_t i = 0; i < count; i++)
+		{
+			dest[i] = (x[i] * mx) + (y[i] * my) + (z[i] * mz) + offset;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void Vector3Cloud::Reserve(size_t count)
+{
+	X.reserve(count);
+	Y.reserve(count);
+	Z.reserve(count);
+}
+
+void Vector3Cloud::Resize(size_t count)
+{
+	X.resize(count);
+	Y.resize(count);
+	Z.resize(count);
+}
+
+void Vector3Cloud::Clear()
+{
+	X.clear();
+	Y.clear();
+	Z.clear();
+}
+
+void Vector3Cloud::Add(const Vector3& v)
+{
+	X.push_back(v.X);
+	Y.push_back(v.Y);
+	Z.push_back(v.Z);
+}
+
+Vector3 Vector3Cloud::Get(size_t index) const
+{
+	return Vector3{ X[index], Y[index], Z[index] };
+}
+
+Vector3Cloud Vector3Cloud::FromPoints(const std::vector<Vector3>& points)
+{
+	Vector3Cloud cloud;
+	cloud.Reserve(points.size());
+	for (const Vector3& point : points)
+	{
+		cloud.Add(point);
+	}
+	return cloud;
+}
+
+std::vector<Vector3> Vector3Cloud::ToPoints() const
+{
+	std::vector<Vector3> points(Size());
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		points[i] = Get(i);
+	}
+	return points;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void TransformCloud(const Vector3Cloud& in, const Matrix43& m, Vector3Cloud* out)
+{
+	assert(out != &in);
+	out->Resize(in.Size());
+	int64_t* dests[3] = { out->X.data(), out->Y.data(), out->Z.data() };
+
+	std::array<AxisSelect, 3> selects;
+	if (TryGetAxisSelects(m, &selects))
+	{
+		const int64_t* sources[3] = { in.X.data(), in.Y.data(), in.Z.data() };
+		for (int axis = 0; axis < 3; axis++)
+		{
+			SelectAxis(sources[selects[axis].Source], selects[axis], dests[axis], in.Size());
+		}
+		return;
+	}
+
+	TransformAxisGeneral(in, m.m00, m.m10, m.m20, m.m30, dests[0]);
+	TransformAxisGeneral(in, m.m01, m.m11, m.m21, m.m31, dests[1]);
+	TransformAxisGeneral(in, m.m02, m.m12, m.m22, m.m32, dests[2]);
+}
+
+void TransformCloudByAllRotations(const Vector3Cloud& in, std::array<Vector3Cloud, 24>* out)
+{
+	const std::array<Matrix43, 24>& rotations = Matrix::AxisAlignedRotations();
+	for (size_t r = 0; r < rotations.size(); r++)
+	{
+		TransformCloud(in, rotations[r], &(*out)[r]);
+	}
+}
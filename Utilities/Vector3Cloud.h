@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Matrix43.h"
+
+#include <array>
+#include <vector>
+#include <stdint.h>
+
+// Points stored as separate X, Y and Z arrays, so transforms stream through contiguous lanes
+struct Vector3Cloud
+{
+	std::vector<int64_t> X;
+	std::vector<int64_t> Y;
+	std::vector<int64_t> Z;
+
+	size_t Size() const { return X.size(); }
+	void Reserve(size_t count);
+	void Resize(size_t count);
+	void Clear();
+
+	void Add(const Vector3& v);
+	Vector3 Get(size_t index) const;
+
+	static Vector3Cloud FromPoints(const std::vector<Vector3>& points);
+	std::vector<Vector3> ToPoints() const;
+};
+
+// Transforms every point as v * m. Axis-aligned rotations (with any translation) reduce to
+// picking and negating source arrays, which runs eight points per instruction with AVX2.
+// out must not be in.
+void TransformCloud(const Vector3Cloud& in, const Matrix43& m, Vector3Cloud* out);
+
+// out[r] is in transformed by Matrix::AxisAlignedRotations()[r]
+void TransformCloudByAllRotations(const Vector3Cloud& in, std::array<Vector3Cloud, 24>* out);